@@ -894,8 +894,6 @@ SDL_UpdateScaletable(void)
 		Cvar_Set("s_volume", "0");
 	}
 
-	s_volume->modified = false;
-
 	for (i = 0; i < 32; i++)
 	{
 		scale = (int)(i * 8 * 256 * s_volume->value);
@@ -1105,18 +1103,6 @@ SDL_Update(void)
 	int total;
 	unsigned int endtime;
 
-    if (s_underwater->modified) {
-        s_underwater->modified = false;
-        lpf_is_enabled = ((int)s_underwater->value != 0);
-    }
-
-    if (s_underwater_gain_hf->modified) {
-        s_underwater_gain_hf->modified = false;
-
-        lpf_initialize(
-            &lpf_context, s_underwater_gain_hf->value, backend->speed);
-    }
-
 	/* if the loading plaque is up, clear everything
 	   out to make sure we aren't looping a dirty
 	   SDL buffer while loading */
@@ -1126,13 +1112,6 @@ SDL_Update(void)
 		return;
 	}
 
-	/* rebuild scale tables if
-	   volume is modified */
-	if (s_volume->modified)
-	{
-		SDL_UpdateScaletable();
-	}
-
 	/* update spatialization
 	   for dynamic sounds */
 	ch = channels;
@@ -1301,6 +1280,24 @@ SDL_Callback(void *data, Uint8 *stream, int length)
 	}
 }
 
+static void
+SDL_VolumeChanged(cvar_t *var)
+{
+	SDL_UpdateScaletable();
+}
+
+static void
+SDL_UnderwaterChanged(cvar_t *var)
+{
+	lpf_is_enabled = ((int)s_underwater->value != 0);
+}
+
+static void
+SDL_UnderwaterGainChanged(cvar_t *var)
+{
+	lpf_initialize(&lpf_context, s_underwater_gain_hf->value, backend->speed);
+}
+
 /*
  * Initializes the SDL sound
  * backend and sets up SDL.
@@ -1449,11 +1446,15 @@ SDL_BackendInit(void)
 	backend->buffer = calloc(1, samplesize);
 	s_numchannels = MAX_CHANNELS;
 
-    s_underwater->modified = true;
-    s_underwater_gain_hf->modified = true;
     lpf_initialize(&lpf_context, lpf_default_gain_hf, backend->speed);
 
 	SDL_UpdateScaletable();
+
+	/* the callbacks run once before the first update */
+	Cvar_Subscribe(s_volume, SDL_VolumeChanged);
+	Cvar_Subscribe(s_underwater, SDL_UnderwaterChanged);
+	Cvar_Subscribe(s_underwater_gain_hf, SDL_UnderwaterGainChanged);
+
 	SDL_PauseAudio(0);
 
 	Com_Printf("SDL audio initialized.\n");
@@ -1471,6 +1472,9 @@ void
 SDL_BackendShutdown(void)
 {
 	Com_Printf("Closing SDL audio device...\n");
+	Cvar_Unsubscribe(s_volume, SDL_VolumeChanged);
+	Cvar_Unsubscribe(s_underwater, SDL_UnderwaterChanged);
+	Cvar_Unsubscribe(s_underwater_gain_hf, SDL_UnderwaterGainChanged);
     SDL_PauseAudio(1);
     SDL_CloseAudio();
     SDL_QuitSubSystem(SDL_INIT_AUDIO);
@@ -27,6 +27,15 @@
 #ifndef UNIX_UNIX_H
 #define UNIX_UNIX_H
 
+#include <time.h>
+
 void registerHandler(void);
 
+#ifdef CLOCK_MONOTONIC
+void Sys_DeadlineToTimespec(int deadline, struct timespec *ts);
+#endif
+
+void Sys_SleepUntil(int deadline);
+void NET_SleepUntil(int deadline);
+
 #endif
@@ -127,13 +127,19 @@ main(int argc, char **argv)
 	/* The legendary Quake II mainloop */
 	while (1)
 	{
-		/* find time spent rendering last frame */
-		do
+		/* sleep until the next frame is due, a
+		   packet arrives or the console has input */
+		NET_SleepUntil(oldtime + Qcommon_FrameDelay());
+
+		/* at least one millisecond must have
+		   passed since the last frame */
+		while ((newtime = Sys_Milliseconds()) - oldtime < 1)
 		{
-			newtime = Sys_Milliseconds();
-			time = newtime - oldtime;
+			Sys_SleepUntil(oldtime + 1);
 		}
-		while (time < 1);
+
+		/* find time spent rendering last frame */
+		time = newtime - oldtime;
 
 		Qcommon_Frame(time);
 		oldtime = newtime;
@@ -24,6 +24,11 @@
  * =======================================================================
  */
 
+/* For recvmmsg() and sendmmsg() - must be before any system include! */
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+ #define _GNU_SOURCE
+#endif
+
 #include "../../common/header/common.h"
 
 #include <unistd.h>
@@ -38,12 +43,34 @@
 #include <arpa/inet.h>
 #include <net/if.h>
 
+#include "header/unix.h"
+
+#if defined(__linux__)
+ #include <sys/epoll.h>
+ #include <sys/timerfd.h>
+#endif
+
 netadr_t net_local_adr;
 
 #define LOOPBACK 0x7f000001
 #define MAX_LOOPBACK 4
 #define QUAKE2MCAST "ff12::666"
 
+/* recvmmsg() and sendmmsg() are used to
+   move several datagrams per syscall */
+#if defined(__linux__)
+ #define HAVE_MMSG
+#endif
+
+/* max number of datagrams moved by one syscall */
+#define NET_BATCH 32
+
+/* NET_SleepUntil() waits for the server sockets
+   and a deadline timer with epoll() */
+#if defined(__linux__)
+ #define HAVE_EPOLL
+#endif
+
 typedef struct
 {
 	byte data[MAX_MSGLEN];
@@ -56,11 +83,37 @@ typedef struct
 	int get, send;
 } loopback_t;
 
+#ifdef HAVE_MMSG
+typedef struct
+{
+	byte data[NET_BATCH][MAX_MSGLEN];
+	struct sockaddr_storage addr[NET_BATCH];
+	struct iovec iov[NET_BATCH];
+	struct mmsghdr hdr[NET_BATCH];
+	int count;      /* number of datagrams in the queue */
+	int current;    /* next datagram to hand out, receive queues only */
+} netqueue_t;
+
+/* per source and protocol (IPv4, IPv6, IPX) */
+static netqueue_t recv_queues[2][3];
+static netqueue_t send_queues[2][3];
+static qboolean send_queueing[2];
+#endif
+
 loopback_t loopbacks[2];
 int ip_sockets[2];
 int ip6_sockets[2];
 int ipx_sockets[2];
 char *multicast_interface = NULL;
+cvar_t *net_batch;
+
+#ifdef HAVE_EPOLL
+/* the descriptors watched by NET_SleepUntil()
+   are stdin and the IPv4, IPv6 and IPX sockets */
+static int net_epoll = -1;
+static int net_timer = -1;
+static int net_watched[4] = {-1, -1, -1, -1};
+#endif
 
 int NET_Socket(char *net_interface, int port, netsrc_t type, int family);
 char *NET_ErrorString(void);
@@ -185,6 +238,7 @@ SockadrToNetadr(struct sockaddr_storage *s, netadr_t *a)
 void
 NET_Init()
 {
+	net_batch = Cvar_Get("net_batch", "1", 0);
 }
 
 qboolean
@@ -510,6 +564,80 @@ NET_SendLoopPacket(netsrc_t sock, int length, void *data, netadr_t to)
 	loop->msgs[i].datalen = length;
 }
 
+#ifdef HAVE_MMSG
+/*
+ * Hands out the next datagram received on the given
+ * socket. If the receive queue is empty it's refilled
+ * with as many datagrams as a single recvmmsg() returns.
+ */
+static qboolean
+NET_GetQueuedPacket(netsrc_t sock, int protocol, int net_socket,
+		netadr_t *net_from, sizebuf_t *net_message)
+{
+	netqueue_t *queue;
+	int ret;
+	int i;
+
+	queue = &recv_queues[sock][protocol];
+
+	while (true)
+	{
+		if (queue->current >= queue->count)
+		{
+			queue->count = 0;
+			queue->current = 0;
+
+			for (i = 0; i < NET_BATCH; i++)
+			{
+				queue->iov[i].iov_base = queue->data[i];
+				queue->iov[i].iov_len = MAX_MSGLEN;
+
+				memset(&queue->hdr[i], 0, sizeof(queue->hdr[i]));
+				queue->hdr[i].msg_hdr.msg_name = &queue->addr[i];
+				queue->hdr[i].msg_hdr.msg_namelen = sizeof(queue->addr[i]);
+				queue->hdr[i].msg_hdr.msg_iov = &queue->iov[i];
+				queue->hdr[i].msg_hdr.msg_iovlen = 1;
+			}
+
+			ret = recvmmsg(net_socket, queue->hdr, NET_BATCH, 0, NULL);
+
+			if (ret == -1)
+			{
+				if ((errno != EWOULDBLOCK) && (errno != ECONNREFUSED))
+				{
+					Com_Printf("NET_GetPacket: %s\n", NET_ErrorString());
+				}
+
+				return false;
+			}
+
+			queue->count = ret;
+
+			if (!ret)
+			{
+				return false;
+			}
+		}
+
+		i = queue->current++;
+
+		SockadrToNetadr(&queue->addr[i], net_from);
+
+		if ((queue->hdr[i].msg_len >= net_message->maxsize) ||
+			(queue->hdr[i].msg_hdr.msg_flags & MSG_TRUNC))
+		{
+			Com_Printf("Oversize packet from %s\n", NET_AdrToString(*net_from));
+			continue;
+		}
+
+		memcpy(net_message->data, queue->data[i], queue->hdr[i].msg_len);
+		net_message->cursize = queue->hdr[i].msg_len;
+
+		return true;
+	}
+}
+#endif
+
 qboolean
 NET_GetPacket(netsrc_t sock, netadr_t *net_from, sizebuf_t *net_message)
 {
@@ -545,6 +673,23 @@ NET_GetPacket(netsrc_t sock, netadr_t *net_from, sizebuf_t *net_message)
 			continue;
 		}
 
+#ifdef HAVE_MMSG
+		/* datagrams already received in a batch must be
+		   handed out even if batching was switched off */
+		if ((net_batch && net_batch->value) ||
+			(recv_queues[sock][protocol].current <
+			 recv_queues[sock][protocol].count))
+		{
+			if (NET_GetQueuedPacket(sock, protocol, net_socket,
+						net_from, net_message))
+			{
+				return true;
+			}
+
+			continue;
+		}
+#endif
+
 		fromlen = sizeof(from);
 		ret = recvfrom(net_socket, net_message->data, net_message->maxsize,
 				0, (struct sockaddr *)&from, &fromlen);
@@ -578,6 +723,109 @@ NET_GetPacket(netsrc_t sock, netadr_t *net_from, sizebuf_t *net_message)
 	return false;
 }
 
+#ifdef HAVE_MMSG
+/*
+ * Sends all datagrams in a send queue
+ * with as few sendmmsg() calls as possible.
+ */
+static void
+NET_FlushQueue(netsrc_t sock, int protocol)
+{
+	netqueue_t *queue;
+	netadr_t to;
+	int net_socket;
+	int sent;
+	int ret;
+
+	queue = &send_queues[sock][protocol];
+
+	if (!queue->count)
+	{
+		return;
+	}
+
+	if (protocol == 0)
+	{
+		net_socket = ip_sockets[sock];
+	}
+	else if (protocol == 1)
+	{
+		net_socket = ip6_sockets[sock];
+	}
+	else
+	{
+		net_socket = ipx_sockets[sock];
+	}
+
+	sent = 0;
+
+	while (net_socket && (sent < queue->count))
+	{
+		ret = sendmmsg(net_socket, &queue->hdr[sent], queue->count - sent, 0);
+
+		if (ret == -1)
+		{
+			/* report and skip the datagram that failed */
+			SockadrToNetadr(&queue->addr[sent], &to);
+			Com_Printf("NET_SendPacket ERROR: %s to %s\n", NET_ErrorString(),
+					NET_AdrToString(to));
+			ret = 1;
+		}
+
+		sent += ret;
+	}
+
+	queue->count = 0;
+}
+
+/*
+ * Appends a datagram to the send queue of the given
+ * socket. The queue is flushed if it runs full.
+ */
+static void
+NET_QueuePacket(netsrc_t sock, int net_socket, int length, void *data,
+		struct sockaddr_storage *addr, int addr_size)
+{
+	netqueue_t *queue;
+	int protocol;
+	int i;
+
+	if (net_socket == ip_sockets[sock])
+	{
+		protocol = 0;
+	}
+	else if (net_socket == ip6_sockets[sock])
+	{
+		protocol = 1;
+	}
+	else
+	{
+		protocol = 2;
+	}
+
+	queue = &send_queues[sock][protocol];
+
+	if (queue->count == NET_BATCH)
+	{
+		NET_FlushQueue(sock, protocol);
+	}
+
+	i = queue->count++;
+
+	memcpy(queue->data[i], data, length);
+	memcpy(&queue->addr[i], addr, sizeof(queue->addr[i]));
+
+	queue->iov[i].iov_base = queue->data[i];
+	queue->iov[i].iov_len = length;
+
+	memset(&queue->hdr[i], 0, sizeof(queue->hdr[i]));
+	queue->hdr[i].msg_hdr.msg_name = &queue->addr[i];
+	queue->hdr[i].msg_hdr.msg_namelen = addr_size;
+	queue->hdr[i].msg_hdr.msg_iov = &queue->iov[i];
+	queue->hdr[i].msg_hdr.msg_iovlen = 1;
+}
+#endif
+
 void
 NET_SendPacket(netsrc_t sock, int length, void *data, netadr_t to)
 {
@@ -716,6 +964,14 @@ NET_SendPacket(netsrc_t sock, int length, void *data, netadr_t to)
 		}
 	}
 
+#ifdef HAVE_MMSG
+	if (send_queueing[sock] && net_batch->value && (length <= MAX_MSGLEN))
+	{
+		NET_QueuePacket(sock, net_socket, length, data, &addr, addr_size);
+		return;
+	}
+#endif
+
 	ret = sendto(net_socket,
 			data,
 			length,
@@ -730,6 +986,37 @@ NET_SendPacket(netsrc_t sock, int length, void *data, netadr_t to)
 	}
 }
 
+/*
+ * Starts collecting the datagrams sent by NET_SendPacket
+ * on the given source instead of sending them one by one.
+ * They're sent by NET_FlushPackets.
+ */
+void
+NET_QueuePackets(netsrc_t sock)
+{
+#ifdef HAVE_MMSG
+	send_queueing[sock] = true;
+#endif
+}
+
+/*
+ * Sends all datagrams collected since NET_QueuePackets
+ */
+void
+NET_FlushPackets(netsrc_t sock)
+{
+#ifdef HAVE_MMSG
+	int protocol;
+
+	for (protocol = 0; protocol < 3; protocol++)
+	{
+		NET_FlushQueue(sock, protocol);
+	}
+
+	send_queueing[sock] = false;
+#endif
+}
+
 void
 NET_OpenIP(void)
 {
@@ -773,6 +1060,21 @@ NET_Config(qboolean multiplayer)
 
 	if (!multiplayer)
 	{
+#ifdef HAVE_MMSG
+		/* drop everything queued for the old sockets */
+		memset(recv_queues, 0, sizeof(recv_queues));
+		memset(send_queues, 0, sizeof(send_queues));
+#endif
+
+#ifdef HAVE_EPOLL
+		/* closing removes the sockets from the epoll
+		   set, they must be added again when reopened */
+		for (i = 1; i < 4; i++)
+		{
+			net_watched[i] = -1;
+		}
+#endif
+
 		/* shut down any existing sockets */
 		for (i = 0; i < 2; i++)
 		{
@@ -979,34 +1281,134 @@ NET_ErrorString(void)
 }
 
 /*
- * sleeps msec or until net socket is ready
+ * Sleeps until the given point in time as returned by
+ * Sys_Milliseconds() or until a server socket or the
+ * console of a dedicated server has input ready.
  */
 void
-NET_Sleep(int msec)
+NET_SleepUntil(int deadline)
 {
-	struct timeval timeout;
-	fd_set fdset;
 	extern cvar_t *dedicated;
 	extern qboolean stdin_active;
+	struct timeval timeout;
+	fd_set fdset;
+	int fds[4];
+	int maxfd;
+	int msec;
+	int i;
+#ifdef HAVE_EPOLL
+	struct epoll_event event;
+	struct epoll_event events[5];
+	struct itimerspec timer;
+	uint64_t expirations;
+#endif
 
-	if ((!ip_sockets[NS_SERVER] &&
-		 !ip6_sockets[NS_SERVER]) || (dedicated && !dedicated->value))
+	fds[0] = (dedicated && dedicated->value && stdin_active) ? 0 : -1;
+	fds[1] = ip_sockets[NS_SERVER] ? ip_sockets[NS_SERVER] : -1;
+	fds[2] = ip6_sockets[NS_SERVER] ? ip6_sockets[NS_SERVER] : -1;
+	fds[3] = ipx_sockets[NS_SERVER] ? ipx_sockets[NS_SERVER] : -1;
+
+#ifdef HAVE_EPOLL
+	if (net_epoll == -1)
 	{
-		return; /* we're not a server, just run full speed */
+		net_epoll = epoll_create(5);
+		net_timer = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK);
+
+		memset(&event, 0, sizeof(event));
+		event.events = EPOLLIN;
+		event.data.fd = net_timer;
+
+		if ((net_epoll == -1) || (net_timer == -1) ||
+			(epoll_ctl(net_epoll, EPOLL_CTL_ADD, net_timer, &event) == -1))
+		{
+			Com_Printf("NET_SleepUntil: %s, falling back to select()\n",
+					NET_ErrorString());
+			net_epoll = -2;
+		}
+	}
+
+	if (net_epoll >= 0)
+	{
+		/* keep the epoll set in sync with the open sockets */
+		for (i = 0; i < 4; i++)
+		{
+			if (net_watched[i] == fds[i])
+			{
+				continue;
+			}
+
+			if (net_watched[i] != -1)
+			{
+				epoll_ctl(net_epoll, EPOLL_CTL_DEL, net_watched[i], NULL);
+			}
+
+			if (fds[i] != -1)
+			{
+				memset(&event, 0, sizeof(event));
+				event.events = EPOLLIN;
+				event.data.fd = fds[i];
+				epoll_ctl(net_epoll, EPOLL_CTL_ADD, fds[i], &event);
+			}
+
+			net_watched[i] = fds[i];
+		}
+
+		/* an absolute deadline doesn't drift with
+		   the time spent before we got here */
+		memset(&timer, 0, sizeof(timer));
+		Sys_DeadlineToTimespec(deadline, &timer.it_value);
+		timerfd_settime(net_timer, TFD_TIMER_ABSTIME, &timer, NULL);
+
+		epoll_wait(net_epoll, events, 5, -1);
+
+		/* clear the expiration, fails with EAGAIN
+		   if a descriptor woke us up before it */
+		if (read(net_timer, &expirations, sizeof(expirations)) == -1)
+		{
+			return;
+		}
+
+		return;
+	}
+#endif
+
+	msec = deadline - Sys_Milliseconds();
+
+	if (msec <= 0)
+	{
+		return;
 	}
 
 	FD_ZERO(&fdset);
+	maxfd = -1;
 
-	if (stdin_active)
+	for (i = 0; i < 4; i++)
 	{
-		FD_SET(0, &fdset); /* stdin is processed too */
+		if (fds[i] != -1)
+		{
+			FD_SET(fds[i], &fdset);
+			maxfd = MAX(maxfd, fds[i]);
+		}
 	}
 
-	FD_SET(ip_sockets[NS_SERVER], &fdset); /* IPv4 network socket */
-	FD_SET(ip6_sockets[NS_SERVER], &fdset); /* IPv6 network socket */
 	timeout.tv_sec = msec / 1000;
 	timeout.tv_usec = (msec % 1000) * 1000;
-	select(MAX(ip_sockets[NS_SERVER],
-					ip6_sockets[NS_SERVER]) + 1, &fdset, NULL, NULL, &timeout);
+	select(maxfd + 1, &fdset, NULL, NULL, &timeout);
 }
 
+/*
+ * sleeps msec or until net socket is ready
+ */
+void
+NET_Sleep(int msec)
+{
+	extern cvar_t *dedicated;
+
+	if ((!ip_sockets[NS_SERVER] &&
+		 !ip6_sockets[NS_SERVER]) || (dedicated && !dedicated->value))
+	{
+		return; /* we're not a server, just run full speed */
+	}
+
+	NET_SleepUntil(Sys_Milliseconds() + msec);
+}
@@ -29,6 +29,7 @@
 #include <stdlib.h>
 #include <limits.h>
 #include <sys/time.h>
+#include <time.h>
 #include <sys/types.h>
 #include <unistd.h>
 #include <fcntl.h>
@@ -44,6 +45,7 @@
 #include <errno.h>
 #include <dlfcn.h>
 #include <dirent.h>
+#include <pthread.h>
 
 #include "../../common/header/common.h"
 #include "../../common/header/glob.h"
@@ -52,6 +54,7 @@
 
 unsigned sys_frame_time;
 int curtime;
+static int secbase;
 static void *game_library;
 
 static char findbase[MAX_OSPATH];
@@ -62,6 +65,21 @@ static DIR *fdir;
 qboolean stdin_active = true;
 extern FILE	*logfile;
 
+/* worker threads of Sys_RunJobs(), the
+   calling thread is always worker 0 */
+static pthread_t job_threads[MAX_JOB_THREADS];
+static int job_numthreads;
+static pthread_mutex_t job_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t job_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t job_start = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t job_done = PTHREAD_COND_INITIALIZER;
+static void (*job_func)(int index, int worker);
+static unsigned int job_generation;
+static int job_workers;    /* threads taking part in the current run */
+static int job_running;    /* worker threads not yet done */
+static int job_count;
+static int job_next;
+
 static qboolean
 CompareAttributes(char *path, char *name, unsigned musthave, unsigned canthave)
 {
@@ -82,9 +100,23 @@ Sys_Init(void)
 int
 Sys_Milliseconds(void)
 {
+#ifdef CLOCK_MONOTONIC
+	struct timespec tp;
+
+	/* the monotonic clock doesn't jump
+	   when the system time is changed */
+	clock_gettime(CLOCK_MONOTONIC, &tp);
+
+	if (!secbase)
+	{
+		secbase = tp.tv_sec;
+		return tp.tv_nsec / 1000000;
+	}
+
+	curtime = (tp.tv_sec - secbase) * 1000 + tp.tv_nsec / 1000000;
+#else
 	struct timeval tp;
 	struct timezone tzp;
-	static int secbase;
 
 	gettimeofday(&tp, &tzp);
 
@@ -95,10 +127,196 @@ Sys_Milliseconds(void)
 	}
 
 	curtime = (tp.tv_sec - secbase) * 1000 + tp.tv_usec / 1000;
+#endif
 
 	return curtime;
 }
 
+long long
+Sys_Nanoseconds(void)
+{
+#ifdef CLOCK_MONOTONIC
+	struct timespec tp;
+
+	clock_gettime(CLOCK_MONOTONIC, &tp);
+
+	return (long long)tp.tv_sec * 1000000000 + tp.tv_nsec;
+#else
+	struct timeval tp;
+
+	gettimeofday(&tp, NULL);
+
+	return (long long)tp.tv_sec * 1000000000 + tp.tv_usec * 1000;
+#endif
+}
+
+#ifdef CLOCK_MONOTONIC
+/*
+ * Converts a point in time as returned by
+ * Sys_Milliseconds() into an absolute time
+ * of the monotonic clock.
+ */
+void
+Sys_DeadlineToTimespec(int deadline, struct timespec *ts)
+{
+	ts->tv_sec = secbase + deadline / 1000;
+	ts->tv_nsec = (long)(deadline % 1000) * 1000000;
+}
+#endif
+
+/*
+ * Sleeps until the given point in time
+ * as returned by Sys_Milliseconds().
+ */
+void
+Sys_SleepUntil(int deadline)
+{
+#if defined(CLOCK_MONOTONIC) && (defined(__linux__) || defined(__FreeBSD__))
+	struct timespec ts;
+
+	Sys_DeadlineToTimespec(deadline, &ts);
+	clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+#else
+	int msec;
+
+	msec = deadline - Sys_Milliseconds();
+
+	if (msec > 0)
+	{
+		usleep(msec * 1000);
+	}
+#endif
+}
+
+/*
+ * Hands out job indices until all are taken
+ */
+static void
+Sys_WorkJobs(int worker)
+{
+	int index;
+
+	while ((index = __sync_fetch_and_add(&job_next, 1)) < job_count)
+	{
+		job_func(index, worker);
+	}
+}
+
+static void *
+Sys_JobThread(void *arg)
+{
+	unsigned int generation;
+	int worker;
+
+	worker = (int)(size_t)arg;
+	generation = 0;
+
+	while (1)
+	{
+		pthread_mutex_lock(&job_mutex);
+
+		while ((job_generation == generation) || (worker >= job_workers))
+		{
+			generation = job_generation;
+			pthread_cond_wait(&job_start, &job_mutex);
+		}
+
+		generation = job_generation;
+		pthread_mutex_unlock(&job_mutex);
+
+		Sys_WorkJobs(worker);
+
+		pthread_mutex_lock(&job_mutex);
+
+		if (--job_running == 0)
+		{
+			pthread_cond_signal(&job_done);
+		}
+
+		pthread_mutex_unlock(&job_mutex);
+	}
+
+	return NULL;
+}
+
+void
+Sys_RunJobs(int count, int threads, void (*job)(int index, int worker))
+{
+	int i;
+
+	if (threads > MAX_JOB_THREADS)
+	{
+		threads = MAX_JOB_THREADS;
+	}
+
+	if (threads > count)
+	{
+		threads = count;
+	}
+
+	/* start missing worker threads */
+	while (job_numthreads < threads - 1)
+	{
+		if (pthread_create(&job_threads[job_numthreads], NULL,
+					Sys_JobThread, (void *)(size_t)(job_numthreads + 1)))
+		{
+			Com_Printf("Sys_RunJobs: couldn't create thread: %s\n",
+					strerror(errno));
+			break;
+		}
+
+		job_numthreads++;
+	}
+
+	if (threads > job_numthreads + 1)
+	{
+		threads = job_numthreads + 1;
+	}
+
+	if (threads <= 1)
+	{
+		for (i = 0; i < count; i++)
+		{
+			job(i, 0);
+		}
+
+		return;
+	}
+
+	pthread_mutex_lock(&job_mutex);
+	job_func = job;
+	job_count = count;
+	job_next = 0;
+	job_workers = threads;
+	job_running = threads - 1;
+	job_generation++;
+	pthread_cond_broadcast(&job_start);
+	pthread_mutex_unlock(&job_mutex);
+
+	Sys_WorkJobs(0);
+
+	pthread_mutex_lock(&job_mutex);
+
+	while (job_running)
+	{
+		pthread_cond_wait(&job_done, &job_mutex);
+	}
+
+	pthread_mutex_unlock(&job_mutex);
+}
+
+void
+Sys_JobLock(void)
+{
+	pthread_mutex_lock(&job_lock);
+}
+
+void
+Sys_JobUnlock(void)
+{
+	pthread_mutex_unlock(&job_lock);
+}
+
 void
 Sys_Mkdir(char *path)
 {
@@ -1209,6 +1209,20 @@ NET_Config(qboolean multiplayer)
 	}
 }
 
+/*
+ * Outgoing datagrams aren't batched
+ * on Windows, they're sent at once
+ */
+void
+NET_QueuePackets(netsrc_t sock)
+{
+}
+
+void
+NET_FlushPackets(netsrc_t sock)
+{
+}
+
 /* 
  * sleeps msec or until
  * net socket is ready
@@ -181,6 +181,31 @@ Sys_Init(void)
 	}
 }
 
+/*
+ * There're no worker threads on
+ * Windows, jobs run one after another
+ */
+void
+Sys_RunJobs(int count, int threads, void (*job)(int index, int worker))
+{
+	int i;
+
+	for (i = 0; i < count; i++)
+	{
+		job(i, 0);
+	}
+}
+
+void
+Sys_JobLock(void)
+{
+}
+
+void
+Sys_JobUnlock(void)
+{
+}
+
 char *
 Sys_ConsoleInput(void)
 {
@@ -429,6 +454,24 @@ Sys_Milliseconds(void)
 	return curtime;
 }
 
+long long
+Sys_Nanoseconds(void)
+{
+	static LARGE_INTEGER freq;
+	LARGE_INTEGER count;
+
+	if (!freq.QuadPart)
+	{
+		QueryPerformanceFrequency(&freq);
+	}
+
+	QueryPerformanceCounter(&count);
+
+	/* split up, count * 1e9 overflows after some hours */
+	return (count.QuadPart / freq.QuadPart) * 1000000000 +
+		   (count.QuadPart % freq.QuadPart) * 1000000000 / freq.QuadPart;
+}
+
 /* ======================================================================= */
 
 static qboolean
@@ -763,6 +806,10 @@ WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance,
 			Sleep(1);
 		}
 
+		/* a dedicated server sleeps until the next
+		   frame is due or a packet arrives */
+		NET_Sleep(Qcommon_FrameDelay());
+
 		while (PeekMessage(&msg, NULL, 0, 0, PM_NOREMOVE))
 		{
 			if (!GetMessage(&msg, NULL, 0, 0))
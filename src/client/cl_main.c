@@ -105,6 +105,9 @@ centity_t cl_entities[MAX_EDICTS];
 
 entity_state_t cl_parse_entities[MAX_PARSE_ENTITIES];
 
+/* milliseconds since the last client frame */
+static int extratime;
+
 extern cvar_t *allow_download;
 extern cvar_t *allow_download_players;
 extern cvar_t *allow_download_models;
@@ -742,10 +745,52 @@ CL_SendCommand(void)
 	CL_CheckForResend();
 }
 
+/*
+ * True while the client talks to a server
+ * and uses the collision model for prediction
+ */
+qboolean
+CL_Connected(void)
+{
+	return cls.state >= ca_connected;
+}
+
+/*
+ * Returns the number of milliseconds until
+ * CL_Frame() runs the next client frame or
+ * -1 if there's no client.
+ */
+int
+CL_FrameDelay(void)
+{
+	int delay;
+
+	if (dedicated->value)
+	{
+		return -1;
+	}
+
+	if (cl_timedemo->value || (cl_maxfps->value <= 0))
+	{
+		return 0;
+	}
+
+	delay = (int)ceil(1000 / cl_maxfps->value);
+
+	/* don't flood packets out while connecting */
+	if ((cls.state == ca_connected) && (delay < 100))
+	{
+		delay = 100;
+	}
+
+	delay -= extratime;
+
+	return delay > 0 ? delay : 0;
+}
+
 void
 CL_Frame(int msec)
 {
-	static int extratime;
 	static int lasttimecalled;
 
 	if (dedicated->value)
@@ -237,7 +237,7 @@ Mod_ForName(char *name, qboolean crash)
 	strcpy(mod->name, name);
 
 	/* load the file */
-	modfilelen = FS_LoadFile(mod->name, (void **)&buf);
+	modfilelen = FS_MapFile(mod->name, (void **)&buf);
 
 	if (!buf)
 	{
@@ -880,7 +880,7 @@ void
 Mod_LoadBrushModel(model_t *mod, void *buffer)
 {
 	int i;
-	dheader_t *header;
+	dheader_t header;
 	mmodel_t *bm;
 
 	loadmodel->type = mod_brush;
@@ -890,9 +890,10 @@ Mod_LoadBrushModel(model_t *mod, void *buffer)
 		VID_Error(ERR_DROP, "Loaded a brush model after the world");
 	}
 
-	header = (dheader_t *)buffer;
+	/* the buffer may be read-only, see FS_MapFile() */
+	header = *(dheader_t *)buffer;
 
-	i = LittleLong(header->version);
+	i = LittleLong(header.version);
 
 	if (i != BSPVERSION)
 	{
@@ -901,26 +902,26 @@ Mod_LoadBrushModel(model_t *mod, void *buffer)
 	}
 
 	/* swap all the lumps */
-	mod_base = (byte *)header;
+	mod_base = (byte *)buffer;
 
 	for (i = 0; i < sizeof(dheader_t) / 4; i++)
 	{
-		((int *)header)[i] = LittleLong(((int *)header)[i]);
+		((int *)&header)[i] = LittleLong(((int *)&header)[i]);
 	}
 
 	/* load into heap */
-	Mod_LoadVertexes(&header->lumps[LUMP_VERTEXES]);
-	Mod_LoadEdges(&header->lumps[LUMP_EDGES]);
-	Mod_LoadSurfedges(&header->lumps[LUMP_SURFEDGES]);
-	Mod_LoadLighting(&header->lumps[LUMP_LIGHTING]);
-	Mod_LoadPlanes(&header->lumps[LUMP_PLANES]);
-	Mod_LoadTexinfo(&header->lumps[LUMP_TEXINFO]);
-	Mod_LoadFaces(&header->lumps[LUMP_FACES]);
-	Mod_LoadMarksurfaces(&header->lumps[LUMP_LEAFFACES]);
-	Mod_LoadVisibility(&header->lumps[LUMP_VISIBILITY]);
-	Mod_LoadLeafs(&header->lumps[LUMP_LEAFS]);
-	Mod_LoadNodes(&header->lumps[LUMP_NODES]);
-	Mod_LoadSubmodels(&header->lumps[LUMP_MODELS]);
+	Mod_LoadVertexes(&header.lumps[LUMP_VERTEXES]);
+	Mod_LoadEdges(&header.lumps[LUMP_EDGES]);
+	Mod_LoadSurfedges(&header.lumps[LUMP_SURFEDGES]);
+	Mod_LoadLighting(&header.lumps[LUMP_LIGHTING]);
+	Mod_LoadPlanes(&header.lumps[LUMP_PLANES]);
+	Mod_LoadTexinfo(&header.lumps[LUMP_TEXINFO]);
+	Mod_LoadFaces(&header.lumps[LUMP_FACES]);
+	Mod_LoadMarksurfaces(&header.lumps[LUMP_LEAFFACES]);
+	Mod_LoadVisibility(&header.lumps[LUMP_VISIBILITY]);
+	Mod_LoadLeafs(&header.lumps[LUMP_LEAFS]);
+	Mod_LoadNodes(&header.lumps[LUMP_NODES]);
+	Mod_LoadSubmodels(&header.lumps[LUMP_MODELS]);
 	mod->numframes = 2; /* regular and alternate animation */
 
 	/* set up the submodels */
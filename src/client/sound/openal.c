@@ -548,29 +548,20 @@ AL_UnqueueRawSamples()
 	AL_StreamDie();
 }
 
-void oal_update_underwater()
+/*
+ * Subscribed to s_underwater and s_underwater_gain_hf
+ */
+static void
+AL_UnderwaterChanged(cvar_t *var)
 {
     int i;
     float gain_hf;
-    qboolean update = false;
     ALuint filter;
 
     if (underwaterFilter == 0)
         return;
 
-    if (s_underwater->modified) {
-        update = true;
-        s_underwater->modified = false;
-        snd_is_underwater_enabled = ((int)s_underwater->value != 0);
-    }
-
-    if (s_underwater_gain_hf->modified) {
-        update = true;
-        s_underwater_gain_hf->modified = false;
-    }
-
-    if (!update)
-        return;
+    snd_is_underwater_enabled = ((int)s_underwater->value != 0);
 
     gain_hf = s_underwater_gain_hf->value;
 
@@ -666,8 +657,6 @@ AL_Update(void)
 
 	AL_StreamUpdate();
 	AL_IssuePlaysounds();
-
-    oal_update_underwater();
 }
 
 /* ----------------------------------------------------------------- */
@@ -766,8 +755,8 @@ AL_InitUnderwaterFilter()
 
     qalFilterf(underwaterFilter, AL_LOWPASS_GAIN, AL_LOWPASS_DEFAULT_GAIN);
 
-    s_underwater->modified = true;
-    s_underwater_gain_hf->modified = true;
+    Cvar_Subscribe(s_underwater, AL_UnderwaterChanged);
+    Cvar_Subscribe(s_underwater_gain_hf, AL_UnderwaterChanged);
 }
 
 /*
@@ -842,6 +831,9 @@ AL_Shutdown(void)
 {
 	Com_Printf("Shutting down OpenAL.\n");
 
+	Cvar_Unsubscribe(s_underwater, AL_UnderwaterChanged);
+	Cvar_Unsubscribe(s_underwater_gain_hf, AL_UnderwaterChanged);
+
 	AL_StreamDie();
 
 	qalDeleteSources(1, &streamSource);
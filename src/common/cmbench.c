@@ -0,0 +1,591 @@
+/*
+ * Copyright (C) 1997-2001 Id Software, Inc.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+ * 02111-1307, USA.
+ *
+ * =======================================================================
+ *
+ * The collision model benchmark. Runs deterministic random queries or
+ * traces recorded in a game against a map and prints throughput,
+ * latency percentiles and a checksum over all results. Two builds
+ * printing the same checksums for a map answered every query the
+ * same.
+ *
+ * =======================================================================
+ */
+
+#include "header/common.h"
+
+#define CMB_DEFAULTCOUNT 100000
+#define CMB_MAXCOUNT 1000000
+#define CMB_MAXLEAFS 128
+#define CMB_MAXRECORD 262144
+#define CMB_VERSION 1
+
+typedef struct
+{
+	vec3_t start, end;
+	vec3_t mins, maxs;
+	int brushmask;
+} cmbtrace_t;
+
+typedef struct
+{
+	char *name;
+	int count;
+	long long total;
+	long long *times;
+	unsigned checksum;
+} cmbresult_t;
+
+qboolean cmb_recording;
+
+static cmbtrace_t *cmb_record;
+static int cmb_numrecord;
+static int cmb_maxrecord;
+static char cmb_recordmap[MAX_QPATH];
+
+static unsigned cmb_seed;
+static vec3_t cmb_mins, cmb_maxs;
+
+/* a player */
+static vec3_t cmb_boxmins = {-16, -16, -24};
+static vec3_t cmb_boxmaxs = {16, 16, 32};
+
+/*
+ * xorshift32, rand() differs between C libraries
+ * and the query sets must be the same everywhere
+ */
+static unsigned
+CMB_Rand(void)
+{
+	cmb_seed ^= cmb_seed << 13;
+	cmb_seed ^= cmb_seed >> 17;
+	cmb_seed ^= cmb_seed << 5;
+
+	return cmb_seed;
+}
+
+static float
+CMB_Random(float lo, float hi)
+{
+	return lo + (hi - lo) * (CMB_Rand() & 0xffffff) / (float)0x1000000;
+}
+
+static void
+CMB_RandomPoint(vec3_t p)
+{
+	int i;
+
+	for (i = 0; i < 3; i++)
+	{
+		p[i] = CMB_Random(cmb_mins[i], cmb_maxs[i]);
+	}
+}
+
+/*
+ * A random start and an end up to 512 units
+ * away, as most game traces are short
+ */
+static void
+CMB_RandomSegment(vec3_t start, vec3_t end)
+{
+	int i;
+
+	CMB_RandomPoint(start);
+
+	for (i = 0; i < 3; i++)
+	{
+		end[i] = start[i] + CMB_Random(-512, 512);
+	}
+}
+
+/* FNV-1a */
+static unsigned
+CMB_Checksum(unsigned hash, const void *data, int length)
+{
+	const byte *p = data;
+	int i;
+
+	for (i = 0; i < length; i++)
+	{
+		hash ^= p[i];
+		hash *= 16777619;
+	}
+
+	return hash;
+}
+
+static unsigned
+CMB_ChecksumTrace(unsigned hash, trace_t *tr)
+{
+	int flags;
+
+	flags = (tr->allsolid ? 1 : 0) | (tr->startsolid ? 2 : 0);
+
+	hash = CMB_Checksum(hash, &flags, sizeof(flags));
+	hash = CMB_Checksum(hash, &tr->fraction, sizeof(tr->fraction));
+	hash = CMB_Checksum(hash, tr->endpos, sizeof(tr->endpos));
+	hash = CMB_Checksum(hash, tr->plane.normal, sizeof(tr->plane.normal));
+	hash = CMB_Checksum(hash, &tr->plane.dist, sizeof(tr->plane.dist));
+	hash = CMB_Checksum(hash, &tr->contents, sizeof(tr->contents));
+	hash = CMB_Checksum(hash, tr->surface->name, strlen(tr->surface->name));
+
+	return hash;
+}
+
+static int
+CMB_CompareTimes(const void *a, const void *b)
+{
+	long long x = *(const long long *)a;
+	long long y = *(const long long *)b;
+
+	return (x > y) - (x < y);
+}
+
+static void
+CMB_Begin(cmbresult_t *res, char *name, int count)
+{
+	memset(res, 0, sizeof(*res));
+	res->name = name;
+	res->checksum = 2166136261u;
+	res->times = Z_Malloc(count * sizeof(long long));
+}
+
+static void
+CMB_End(cmbresult_t *res)
+{
+	long long *t;
+	int n;
+
+	n = res->count;
+	t = res->times;
+
+	if (n)
+	{
+		qsort(t, n, sizeof(long long), CMB_CompareTimes);
+
+		Com_Printf("%-14s %8i %10.0f/s  p50 %6lli  p90 %6lli  p99 %6lli"
+				"  max %8lli ns  %08x\n", res->name, n,
+				n * 1e9 / (res->total ? res->total : 1), t[n / 2],
+				t[n * 9 / 10], t[n * 99 / 100], t[n - 1], res->checksum);
+	}
+
+	Z_Free(res->times);
+}
+
+/* times a single query, the clock reads are part of the result */
+#define CMB_TIME(res, query) \
+	{ \
+		long long t0 = Sys_Nanoseconds(); \
+		query; \
+		(res)->times[(res)->count] = Sys_Nanoseconds() - t0; \
+		(res)->total += (res)->times[(res)->count++]; \
+	}
+
+static void
+CMB_BenchTraces(char *name, int count, vec3_t mins, vec3_t maxs, int mask)
+{
+	cmbresult_t res;
+	vec3_t start, end;
+	trace_t tr;
+	int i;
+
+	CMB_Begin(&res, name, count);
+
+	for (i = 0; i < count; i++)
+	{
+		CMB_RandomSegment(start, end);
+		CMB_TIME(&res, tr = CM_BoxTrace(start, end, mins, maxs, 0, mask));
+		res.checksum = CMB_ChecksumTrace(res.checksum, &tr);
+	}
+
+	CMB_End(&res);
+}
+
+static void
+CMB_BenchContents(int count)
+{
+	cmbresult_t res;
+	vec3_t p;
+	int i, contents;
+
+	CMB_Begin(&res, "pointcontents", count);
+
+	for (i = 0; i < count; i++)
+	{
+		CMB_RandomPoint(p);
+		CMB_TIME(&res, contents = CM_PointContents(p, 0));
+		res.checksum = CMB_Checksum(res.checksum, &contents, sizeof(contents));
+	}
+
+	CMB_End(&res);
+}
+
+static void
+CMB_BenchLeafnums(int count)
+{
+	cmbresult_t res;
+	vec3_t mins, maxs;
+	int leafs[CMB_MAXLEAFS];
+	int i, j, num, topnode;
+
+	CMB_Begin(&res, "boxleafnums", count);
+
+	for (i = 0; i < count; i++)
+	{
+		CMB_RandomPoint(mins);
+
+		for (j = 0; j < 3; j++)
+		{
+			maxs[j] = mins[j] + CMB_Random(1, 128);
+		}
+
+		CMB_TIME(&res, num = CM_BoxLeafnums(mins, maxs, leafs,
+					CMB_MAXLEAFS, &topnode));
+		res.checksum = CMB_Checksum(res.checksum, &topnode, sizeof(topnode));
+		res.checksum = CMB_Checksum(res.checksum, leafs, num * sizeof(int));
+	}
+
+	CMB_End(&res);
+}
+
+static void
+CMB_BenchPVS(int count)
+{
+	cmbresult_t res;
+	byte *row;
+	int i, cluster, numclusters;
+
+	numclusters = CM_NumClusters();
+
+	if (numclusters <= 0)
+	{
+		return;
+	}
+
+	CMB_Begin(&res, "clusterpvs", count);
+
+	for (i = 0; i < count; i++)
+	{
+		cluster = CMB_Rand() % numclusters;
+		CMB_TIME(&res, row = CM_ClusterPVS(cluster));
+		res.checksum = CMB_Checksum(res.checksum, row, (numclusters + 7) >> 3);
+	}
+
+	CMB_End(&res);
+}
+
+static void
+CMB_BenchReplay(void)
+{
+	cmbresult_t res;
+	cmbtrace_t *r;
+	trace_t tr;
+	int i;
+
+	CMB_Begin(&res, "replay", cmb_numrecord);
+
+	for (i = 0, r = cmb_record; i < cmb_numrecord; i++, r++)
+	{
+		CMB_TIME(&res, tr = CM_BoxTrace(r->start, r->end, r->mins, r->maxs,
+					0, r->brushmask));
+		res.checksum = CMB_ChecksumTrace(res.checksum, &tr);
+	}
+
+	CMB_End(&res);
+}
+
+/*
+ * Loads the map for a benchmark. The collision model only
+ * holds one map, so this isn't possible while a server runs
+ * or the client is connected to one.
+ */
+static qboolean
+CMB_LoadMap(char *name)
+{
+	char path[MAX_QPATH];
+	unsigned checksum;
+	cmodel_t *world;
+	int i;
+
+	if (Com_ServerState())
+	{
+		Com_Printf("cmbench: kill the server first\n");
+		return false;
+	}
+
+#ifndef DEDICATED_ONLY
+	if (CL_Connected())
+	{
+		Com_Printf("cmbench: disconnect first\n");
+		return false;
+	}
+#endif
+
+	Com_sprintf(path, sizeof(path), "maps/%s.bsp", name);
+	world = CM_LoadMap(path, false, &checksum);
+
+	/* a little outside the world, traces
+	   leaving it are part of the game too */
+	for (i = 0; i < 3; i++)
+	{
+		cmb_mins[i] = world->mins[i] - 64;
+		cmb_maxs[i] = world->maxs[i] + 64;
+	}
+
+	Com_Printf("%s: %i clusters, checksum %08x\n", path,
+			CM_NumClusters(), checksum);
+
+	return true;
+}
+
+/*
+ * Called by CM_BoxTrace() while recording
+ */
+void
+CMB_RecordTrace(vec3_t start, vec3_t end, vec3_t mins, vec3_t maxs,
+		int headnode, int brushmask)
+{
+	cmbtrace_t *r;
+
+	/* only world traces, the box hull
+	   changes between the other ones */
+	if (headnode != 0)
+	{
+		return;
+	}
+
+	r = &cmb_record[cmb_numrecord++];
+	VectorCopy(start, r->start);
+	VectorCopy(end, r->end);
+	VectorCopy(mins, r->mins);
+	VectorCopy(maxs, r->maxs);
+	r->brushmask = brushmask;
+
+	if (cmb_numrecord == cmb_maxrecord)
+	{
+		cmb_recording = false;
+		Com_Printf("cmbench: recorded %i traces on %s\n",
+				cmb_numrecord, cmb_recordmap);
+	}
+}
+
+static void
+CMB_StartRecord(int count)
+{
+	if (!Com_ServerState())
+	{
+		Com_Printf("cmbench: no map running to record\n");
+		return;
+	}
+
+	if ((count <= 0) || (count > CMB_MAXRECORD))
+	{
+		count = CMB_MAXRECORD;
+	}
+
+	if (cmb_record)
+	{
+		Z_Free(cmb_record);
+	}
+
+	cmb_record = Z_Malloc(count * sizeof(cmbtrace_t));
+	cmb_numrecord = 0;
+	cmb_maxrecord = count;
+	Q_strlcpy(cmb_recordmap, (char *)Cvar_VariableString("mapname"),
+			sizeof(cmb_recordmap));
+
+	cmb_recording = true;
+	Com_Printf("cmbench: recording %i traces on %s\n", count, cmb_recordmap);
+}
+
+/*
+ * The recording is written as is, it's only
+ * meant to be read back on the same platform
+ */
+static void
+CMB_Save(char *name)
+{
+	char path[MAX_OSPATH];
+	int header[3];
+	FILE *f;
+
+	if (cmb_recording || !cmb_numrecord)
+	{
+		Com_Printf("cmbench: nothing recorded yet\n");
+		return;
+	}
+
+	Com_sprintf(path, sizeof(path), "%s/%s.cmb", FS_Gamedir(), name);
+
+	if (!(f = fopen(path, "wb")))
+	{
+		Com_Printf("cmbench: couldn't write %s\n", path);
+		return;
+	}
+
+	header[0] = CMB_VERSION;
+	header[1] = cmb_numrecord;
+	header[2] = sizeof(cmbtrace_t);
+
+	fwrite(header, sizeof(header), 1, f);
+	fwrite(cmb_recordmap, sizeof(cmb_recordmap), 1, f);
+	fwrite(cmb_record, sizeof(cmbtrace_t), cmb_numrecord, f);
+	fclose(f);
+
+	Com_Printf("cmbench: wrote %s\n", path);
+}
+
+static void
+CMB_Load(char *name)
+{
+	char path[MAX_QPATH];
+	int header[3];
+	byte *buf;
+	int len;
+
+	Com_sprintf(path, sizeof(path), "%s.cmb", name);
+	len = FS_LoadFile(path, (void **)&buf);
+
+	if (!buf)
+	{
+		Com_Printf("cmbench: couldn't load %s\n", path);
+		return;
+	}
+
+	if (len < (int)(sizeof(header) + MAX_QPATH))
+	{
+		Com_Printf("cmbench: %s is broken or from another build\n", path);
+		FS_FreeFile(buf);
+		return;
+	}
+
+	memcpy(header, buf, sizeof(header));
+
+	if ((header[0] != CMB_VERSION) || (header[2] != sizeof(cmbtrace_t)) ||
+		(header[1] <= 0) || (header[1] > CMB_MAXRECORD) ||
+		(len != (int)(sizeof(header) + MAX_QPATH +
+					header[1] * sizeof(cmbtrace_t))))
+	{
+		Com_Printf("cmbench: %s is broken or from another build\n", path);
+		FS_FreeFile(buf);
+		return;
+	}
+
+	if (cmb_record)
+	{
+		Z_Free(cmb_record);
+	}
+
+	cmb_recording = false;
+	cmb_numrecord = cmb_maxrecord = header[1];
+	cmb_record = Z_Malloc(cmb_numrecord * sizeof(cmbtrace_t));
+
+	memcpy(cmb_recordmap, buf + sizeof(header), MAX_QPATH);
+	cmb_recordmap[MAX_QPATH - 1] = '\0';
+	memcpy(cmb_record, buf + sizeof(header) + MAX_QPATH,
+			cmb_numrecord * sizeof(cmbtrace_t));
+
+	FS_FreeFile(buf);
+
+	Com_Printf("cmbench: %i traces on %s\n", cmb_numrecord, cmb_recordmap);
+}
+
+static void
+CMB_Usage(void)
+{
+	Com_Printf("cmbench run <map> [count] [seed] : random queries\n");
+	Com_Printf("cmbench record [count]          : record world traces\n");
+	Com_Printf("cmbench save <name>             : write the recording\n");
+	Com_Printf("cmbench load <name>             : read a recording\n");
+	Com_Printf("cmbench replay                  : replay the recording\n");
+	Com_Printf("run and replay need the server to be down.\n");
+}
+
+void
+CMB_Bench_f(void)
+{
+	char *cmd;
+	unsigned seed;
+	int count;
+
+	cmd = Cmd_Argv(1);
+
+	if (!strcmp(cmd, "run") && (Cmd_Argc() >= 3))
+	{
+		count = (Cmd_Argc() > 3) ? (int)strtol(Cmd_Argv(3), NULL, 10) :
+			CMB_DEFAULTCOUNT;
+		count = (count <= 0) ? CMB_DEFAULTCOUNT : count;
+		count = (count > CMB_MAXCOUNT) ? CMB_MAXCOUNT : count;
+
+		if (!CMB_LoadMap(Cmd_Argv(2)))
+		{
+			return;
+		}
+
+		/* each query type starts at the same
+		   seed, so the sets don't depend on
+		   which types are run */
+		seed = (Cmd_Argc() > 4) ?
+			(unsigned)strtoul(Cmd_Argv(4), NULL, 10) : 1;
+		seed = seed ? seed : 1;
+
+		cmb_seed = seed;
+		CMB_BenchTraces("pointtrace", count, vec3_origin, vec3_origin,
+				MASK_ALL);
+		cmb_seed = seed;
+		CMB_BenchTraces("boxtrace", count, cmb_boxmins, cmb_boxmaxs,
+				MASK_PLAYERSOLID);
+		cmb_seed = seed;
+		CMB_BenchContents(count);
+		cmb_seed = seed;
+		CMB_BenchLeafnums(count);
+		cmb_seed = seed;
+		CMB_BenchPVS(count);
+	}
+	else if (!strcmp(cmd, "record"))
+	{
+		CMB_StartRecord((Cmd_Argc() > 2) ?
+				(int)strtol(Cmd_Argv(2), NULL, 10) : 0);
+	}
+	else if (!strcmp(cmd, "save") && (Cmd_Argc() == 3))
+	{
+		CMB_Save(Cmd_Argv(2));
+	}
+	else if (!strcmp(cmd, "load") && (Cmd_Argc() == 3))
+	{
+		CMB_Load(Cmd_Argv(2));
+	}
+	else if (!strcmp(cmd, "replay"))
+	{
+		if (cmb_recording || !cmb_numrecord)
+		{
+			Com_Printf("cmbench: nothing recorded\n");
+			return;
+		}
+
+		if (CMB_LoadMap(cmb_recordmap))
+		{
+			CMB_BenchReplay();
+		}
+	}
+	else
+	{
+		CMB_Usage();
+	}
+}
@@ -30,23 +30,34 @@
 
 #define MAX_ALIAS_NAME 32
 #define ALIAS_LOOP_COUNT 16
+#define CMD_HASH_SIZE 256
+#define CBUF_SIZE 8192 /* power of two, it's a ring */
 
 typedef struct cmd_function_s
 {
 	struct cmd_function_s *next;
+	struct cmd_function_s *hashNext;
 	char *name;
 	xcommand_t function;
 } cmd_function_t;
 
 static cmd_function_t *cmd_functions; /* possible commands to execute */
 
+/* Chains are sorted like cmd_functions, so the first
+   case insensitive match is the one the list gives. */
+static cmd_function_t *cmd_hash[CMD_HASH_SIZE];
+
 typedef struct cmdalias_s
 {
 	struct cmdalias_s *next;
+	struct cmdalias_s *hashNext;
 	char name[MAX_ALIAS_NAME];
 	char *value;
 } cmdalias_t;
 
+/* Newest first, like cmd_alias. */
+static cmdalias_t *cmd_aliashash[CMD_HASH_SIZE];
+
 char retval[256];
 int alias_count; /* for detecting runaway loops */
 cmdalias_t *cmd_alias;
@@ -56,9 +67,51 @@ static int cmd_argc;
 static char *cmd_argv[MAX_STRING_TOKENS];
 static char *cmd_null_string = "";
 static char cmd_args[MAX_STRING_CHARS];
-sizebuf_t cmd_text;
-byte cmd_text_buf[8192];
-char defer_text_buf[8192];
+
+/* The command text is a ring, so text can be added at
+   either end without moving what's already there. */
+static char cmd_text_buf[CBUF_SIZE];
+static int cmd_text_head; /* next char to execute */
+static int cmd_text_size;
+char defer_text_buf[CBUF_SIZE];
+
+/* case insensitive, commands and aliases
+   are executed regardless of case */
+#define Cmd_HashName(name) (Q_strhash(name) & (CMD_HASH_SIZE - 1))
+
+static cmd_function_t *
+Cmd_FindCommand(const char *name, qboolean anycase)
+{
+	cmd_function_t *cmd;
+
+	for (cmd = cmd_hash[Cmd_HashName(name)]; cmd; cmd = cmd->hashNext)
+	{
+		if (anycase ? !Q_strcasecmp((char *)name, cmd->name) :
+			!strcmp(name, cmd->name))
+		{
+			return cmd;
+		}
+	}
+
+	return NULL;
+}
+
+static cmdalias_t *
+Cmd_FindAlias(const char *name, qboolean anycase)
+{
+	cmdalias_t *a;
+
+	for (a = cmd_aliashash[Cmd_HashName(name)]; a; a = a->hashNext)
+	{
+		if (anycase ? !Q_strcasecmp((char *)name, a->name) :
+			!strcmp(name, a->name))
+		{
+			return a;
+		}
+	}
+
+	return NULL;
+}
 
 /*
  * Causes execution of the remainder of the command buffer to be delayed
@@ -74,7 +127,48 @@ Cmd_Wait_f(void)
 void
 Cbuf_Init(void)
 {
-	SZ_Init(&cmd_text, cmd_text_buf, sizeof(cmd_text_buf));
+	cmd_text_head = 0;
+	cmd_text_size = 0;
+}
+
+/*
+ * Copies text into the ring, starting at pos
+ */
+static void
+Cbuf_Write(int pos, const char *text, int length)
+{
+	int l;
+
+	pos &= CBUF_SIZE - 1;
+	l = CBUF_SIZE - pos;
+
+	if (l > length)
+	{
+		l = length;
+	}
+
+	memcpy(cmd_text_buf + pos, text, l);
+	memcpy(cmd_text_buf, text + l, length - l);
+}
+
+/*
+ * Copies text out of the ring, starting at pos
+ */
+static void
+Cbuf_Read(int pos, char *text, int length)
+{
+	int l;
+
+	pos &= CBUF_SIZE - 1;
+	l = CBUF_SIZE - pos;
+
+	if (l > length)
+	{
+		l = length;
+	}
+
+	memcpy(text, cmd_text_buf + pos, l);
+	memcpy(text + l, cmd_text_buf, length - l);
 }
 
 /*
@@ -87,56 +181,45 @@ Cbuf_AddText(char *text)
 
 	l = strlen(text);
 
-	if (cmd_text.cursize + l >= cmd_text.maxsize)
+	if (cmd_text_size + l >= CBUF_SIZE)
 	{
 		Com_Printf("Cbuf_AddText: overflow\n");
 		return;
 	}
 
-	SZ_Write(&cmd_text, text, strlen(text));
+	Cbuf_Write(cmd_text_head + cmd_text_size, text, l);
+	cmd_text_size += l;
 }
 
 /*
- * Adds command text immediately after the current command
- * Adds a \n to the text
+ * Adds command text immediately after the current command.
+ * The remaining commands stay where they are, the text
+ * goes in front of them.
  */
 void
 Cbuf_InsertText(char *text)
 {
-	char *temp;
-	int templen;
+	int l;
 
-	/* copy off any commands still remaining in the exec buffer */
-	templen = cmd_text.cursize;
+	l = strlen(text);
 
-	if (templen)
+	if (cmd_text_size + l >= CBUF_SIZE)
 	{
-		temp = Z_Malloc(templen);
-		memcpy(temp, cmd_text.data, templen);
-		SZ_Clear(&cmd_text);
-	}
-	else
-	{
-		temp = NULL;
+		Com_Printf("Cbuf_InsertText: overflow\n");
+		return;
 	}
 
-	/* add the entire text of the file */
-	Cbuf_AddText(text);
-
-	/* add the copied off data */
-	if (templen)
-	{
-		SZ_Write(&cmd_text, temp, templen);
-		Z_Free(temp);
-	}
+	cmd_text_head = (cmd_text_head - l) & (CBUF_SIZE - 1);
+	cmd_text_size += l;
+	Cbuf_Write(cmd_text_head, text, l);
 }
 
 void
 Cbuf_CopyToDefer(void)
 {
-	memcpy(defer_text_buf, cmd_text_buf, cmd_text.cursize);
-	defer_text_buf[cmd_text.cursize] = 0;
-	cmd_text.cursize = 0;
+	Cbuf_Read(cmd_text_head, defer_text_buf, cmd_text_size);
+	defer_text_buf[cmd_text_size] = 0;
+	cmd_text_size = 0;
 }
 
 void
@@ -168,63 +251,52 @@ Cbuf_ExecuteText(int exec_when, char *text)
 void
 Cbuf_Execute(void)
 {
-	int i;
-	char *text;
+	int i, l;
+	char c;
 	char line[1024];
 	int quotes;
 
 	alias_count = 0; /* don't allow infinite alias loops */
 
-	while (cmd_text.cursize)
+	while (cmd_text_size)
 	{
 		/* find a \n or ; line break */
-		text = (char *)cmd_text.data;
-
 		quotes = 0;
 
-		for (i = 0; i < cmd_text.cursize; i++)
+		for (i = 0; i < cmd_text_size; i++)
 		{
-			if (text[i] == '"')
+			c = cmd_text_buf[(cmd_text_head + i) & (CBUF_SIZE - 1)];
+
+			if (c == '"')
 			{
 				quotes++;
 			}
 
-			if (!(quotes & 1) && (text[i] == ';'))
+			if (!(quotes & 1) && (c == ';'))
 			{
 				break; /* don't break if inside a quoted string */
 			}
 
-			if (text[i] == '\n')
+			if (c == '\n')
 			{
 				break;
 			}
 		}
 
-		if (i > sizeof(line) - 1)
-		{
-			memcpy(line, text, sizeof(line) - 1);
-			line[sizeof(line) - 1] = 0;
-		}
-		else
-		{
-			memcpy(line, text, i);
-			line[i] = 0;
-		}
+		l = (i > sizeof(line) - 1) ? sizeof(line) - 1 : i;
+		Cbuf_Read(cmd_text_head, line, l);
+		line[l] = 0;
 
-		/* delete the text from the command buffer and move remaining
-		   commands down this is necessary because commands (exec,
-		   alias) can insert data at the beginning of the text buffer */
-		if (i == cmd_text.cursize)
-		{
-			cmd_text.cursize = 0;
-		}
-		else
+		/* consume the line and its break before executing it,
+		   commands (exec, alias) may insert text in front */
+		if (i < cmd_text_size)
 		{
 			i++;
-			cmd_text.cursize -= i;
-			memmove(text, text + i, cmd_text.cursize);
 		}
 
+		cmd_text_head = (cmd_text_head + i) & (CBUF_SIZE - 1);
+		cmd_text_size -= i;
+
 		/* execute the command line */
 		Cmd_ExecuteString(line);
 
@@ -368,7 +440,7 @@ Cmd_Exec_f(void)
 		return;
 	}
 
-	len = FS_LoadFile(Cmd_Argv(1), (void **)&f);
+	len = FS_MapFile(Cmd_Argv(1), (void **)&f);
 
 	if (!f)
 	{
@@ -415,6 +487,7 @@ Cmd_Alias_f(void)
 	cmdalias_t *a;
 	char cmd[1024];
 	int i, c;
+	unsigned hash;
 	char *s;
 
 	if (Cmd_Argc() == 1)
@@ -438,20 +511,21 @@ Cmd_Alias_f(void)
 	}
 
 	/* if the alias already exists, reuse it */
-	for (a = cmd_alias; a; a = a->next)
+	a = Cmd_FindAlias(s, false);
+
+	if (a)
 	{
-		if (!strcmp(s, a->name))
-		{
-			Z_Free(a->value);
-			break;
-		}
+		Z_Free(a->value);
 	}
-
-	if (!a)
+	else
 	{
 		a = Z_Malloc(sizeof(cmdalias_t));
 		a->next = cmd_alias;
 		cmd_alias = a;
+
+		hash = Cmd_HashName(s);
+		a->hashNext = cmd_aliashash[hash];
+		cmd_aliashash[hash] = a;
 	}
 
 	strcpy(a->name, s);
@@ -689,13 +763,10 @@ Cmd_AddCommand(char *cmd_name, xcommand_t function)
 	}
 
 	/* fail if the command already exists */
-	for (cmd = cmd_functions; cmd; cmd = cmd->next)
+	if (Cmd_FindCommand(cmd_name, false))
 	{
-		if (!strcmp(cmd_name, cmd->name))
-		{
-			Com_Printf("Cmd_AddCommand: %s already defined\n", cmd_name);
-			return;
-		}
+		Com_Printf("Cmd_AddCommand: %s already defined\n", cmd_name);
+		return;
 	}
 
 	cmd = Z_Malloc(sizeof(cmd_function_t));
@@ -710,6 +781,14 @@ Cmd_AddCommand(char *cmd_name, xcommand_t function)
 	}
 	cmd->next = *pos;
 	*pos = cmd;
+
+	pos = &cmd_hash[Cmd_HashName(cmd->name)];
+	while (*pos && strcmp((*pos)->name, cmd->name) < 0)
+	{
+		pos = &(*pos)->hashNext;
+	}
+	cmd->hashNext = *pos;
+	*pos = cmd;
 }
 
 void
@@ -732,28 +811,28 @@ Cmd_RemoveCommand(char *cmd_name)
 		if (!strcmp(cmd_name, cmd->name))
 		{
 			*back = cmd->next;
-			Z_Free(cmd);
-			return;
+			break;
 		}
 
 		back = &cmd->next;
 	}
-}
 
-qboolean
-Cmd_Exists(char *cmd_name)
-{
-	cmd_function_t *cmd;
-
-	for (cmd = cmd_functions; cmd; cmd = cmd->next)
+	for (back = &cmd_hash[Cmd_HashName(cmd_name)]; *back; back = &(*back)->hashNext)
 	{
-		if (!strcmp(cmd_name, cmd->name))
+		if (*back == cmd)
 		{
-			return true;
+			*back = cmd->hashNext;
+			break;
 		}
 	}
 
-	return false;
+	Z_Free(cmd);
+}
+
+qboolean
+Cmd_Exists(char *cmd_name)
+{
+	return Cmd_FindCommand(cmd_name, false) != NULL;
 }
 
 int
@@ -780,20 +859,18 @@ Cmd_CompleteCommand(char *partial)
 	}
 
 	/* check for exact match */
-	for (cmd = cmd_functions; cmd; cmd = cmd->next)
+	cmd = Cmd_FindCommand(partial, false);
+
+	if (cmd)
 	{
-		if (!strcmp(partial, cmd->name))
-		{
-			return cmd->name;
-		}
+		return cmd->name;
 	}
 
-	for (a = cmd_alias; a; a = a->next)
+	a = Cmd_FindAlias(partial, false);
+
+	if (a)
 	{
-		if (!strcmp(partial, a->name))
-		{
-			return a->name;
-		}
+		return a->name;
 	}
 
 	for (cvar = cvar_vars; cvar; cvar = cvar->next)
@@ -889,25 +966,12 @@ Cmd_CompleteCommand(char *partial)
 qboolean
 Cmd_IsComplete(char *command)
 {
-	cmd_function_t *cmd;
-	cmdalias_t *a;
 	cvar_t *cvar;
 
 	/* check for exact match */
-	for (cmd = cmd_functions; cmd; cmd = cmd->next)
-	{
-		if (!strcmp(command, cmd->name))
-		{
-			return true;
-		}
-	}
-
-	for (a = cmd_alias; a; a = a->next)
+	if (Cmd_FindCommand(command, false) || Cmd_FindAlias(command, false))
 	{
-		if (!strcmp(command, a->name))
-		{
-			return true;
-		}
+		return true;
 	}
 
 	for (cvar = cvar_vars; cvar; cvar = cvar->next)
@@ -948,38 +1012,36 @@ Cmd_ExecuteString(char *text)
 	}
 
 	/* check functions */
-	for (cmd = cmd_functions; cmd; cmd = cmd->next)
+	cmd = Cmd_FindCommand(cmd_argv[0], true);
+
+	if (cmd)
 	{
-		if (!Q_strcasecmp(cmd_argv[0], cmd->name))
+		if (!cmd->function)
 		{
-			if (!cmd->function)
-			{
-				/* forward to server command */
-				Cmd_ExecuteString(va("cmd %s", text));
-			}
-			else
-			{
-				cmd->function();
-			}
-
-			return;
+			/* forward to server command */
+			Cmd_ExecuteString(va("cmd %s", text));
+		}
+		else
+		{
+			cmd->function();
 		}
+
+		return;
 	}
 
 	/* check alias */
-	for (a = cmd_alias; a; a = a->next)
+	a = Cmd_FindAlias(cmd_argv[0], true);
+
+	if (a)
 	{
-		if (!Q_strcasecmp(cmd_argv[0], a->name))
+		if (++alias_count == ALIAS_LOOP_COUNT)
 		{
-			if (++alias_count == ALIAS_LOOP_COUNT)
-			{
-				Com_Printf("ALIAS_LOOP_COUNT\n");
-				return;
-			}
-
-			Cbuf_InsertText(a->value);
+			Com_Printf("ALIAS_LOOP_COUNT\n");
 			return;
 		}
+
+		Cbuf_InsertText(a->value);
+		return;
 	}
 
 	/* check cvars */
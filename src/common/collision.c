@@ -27,6 +27,11 @@
 
 #include "header/common.h"
 
+#if defined(__SSE__) || defined(_M_X64)
+ #include <xmmintrin.h>
+ #define CM_SIMD
+#endif
+
 typedef struct
 {
 	cplane_t	*plane;
@@ -53,9 +58,20 @@ typedef struct
 	int			contents;
 	int			numsides;
 	int			firstbrushside;
-	int			checkcount;	/* to avoid repeated testings */
+#ifdef CM_SIMD
+	int			firstsoa; /* -1 if the brush has none */
+#endif
 } cbrush_t;
 
+#ifdef CM_SIMD
+/* the planes of four brush sides, one lane each */
+typedef struct
+{
+	float		normal[3][4];
+	float		dist[4];
+} cbrushsoa_t;
+#endif
+
 typedef struct
 {
 	int		numareaportals;
@@ -66,8 +82,6 @@ typedef struct
 
 byte *cmod_base;
 byte map_visibility[MAX_MAP_VISIBILITY];
-byte pvsrow[MAX_MAP_LEAFS / 8];
-byte phsrow[MAX_MAP_LEAFS / 8];
 carea_t	map_areas[MAX_MAP_AREAS];
 cbrush_t map_brushes[MAX_MAP_BRUSHES];
 cbrushside_t map_brushsides[MAX_MAP_BRUSHSIDES];
@@ -81,16 +95,12 @@ cnode_t	map_nodes[MAX_MAP_NODES+6]; /* extra for box hull */
 cplane_t *box_planes;
 cplane_t map_planes[MAX_MAP_PLANES+6]; /* extra for box hull */
 cvar_t *map_noareas;
+cvar_t *map_simdclip;
 dareaportal_t map_areaportals[MAX_MAP_AREAPORTALS];
 dvis_t *map_vis = (dvis_t *)map_visibility;
 int box_headnode;
-int	checkcount;
 int	emptyleaf, solidleaf;
 int	floodvalid;
-float *leaf_mins, *leaf_maxs;
-int leaf_count, leaf_maxcount;
-int *leaf_list;
-int leaf_topnode;
 int	numareaportals;
 int numareas = 1;
 int	numbrushes;
@@ -104,16 +114,68 @@ int	numnodes;
 int	numplanes;
 int	numtexinfo;
 int	numvisibility;
-int trace_contents;
 mapsurface_t map_surfaces[MAX_MAP_TEXINFO];
 mapsurface_t nullsurface;
+#ifdef CM_SIMD
+cbrushsoa_t map_brushsoa[MAX_MAP_BRUSHSIDES / 4 + MAX_MAP_BRUSHES];
+#endif
 qboolean portalopen[MAX_MAP_AREAPORTALS];
-qboolean trace_ispoint; /* optimized case */
-trace_t trace_trace;
 unsigned short	map_leafbrushes[MAX_MAP_LEAFBRUSHES];
-vec3_t trace_start, trace_end;
-vec3_t trace_mins, trace_maxs;
-vec3_t trace_extents;
+
+/* Everything a trace needs besides the map. The old entry
+   points share cm_trace, other threads need their own. */
+struct cmtrace_s
+{
+	trace_t trace;
+	vec3_t start, end;
+	vec3_t mins, maxs;
+	vec3_t extents;
+	int contents;
+	qboolean ispoint; /* optimized case */
+
+	/* to avoid testing a brush again in the next leaf */
+	int checkcount;
+	int *brushcheck;
+	int numbrushcheck;
+
+	/* box hull planes, NULL to use box_planes */
+	cplane_t *boxplanes;
+	cplane_t ownboxplanes[12];
+};
+
+static cmtrace_t cm_trace;
+
+/* CM_BoxLeafnums() state */
+typedef struct
+{
+	cmtrace_t *ctx;
+	float *mins, *maxs;
+	int count, maxcount;
+	int *list;
+	int topnode;
+} leafquery_t;
+
+/* decompressed PVS and PHS rows, see CM_InitVisCache */
+#define VIS_MINSLOTS 64
+
+typedef struct
+{
+	int key; /* cluster * 2 + DVIS_PVS or DVIS_PHS, -1 if unused */
+	int prev, next; /* LRU links, most recently used first */
+} visslot_t;
+
+static byte vis_nullrow[MAX_MAP_LEAFS / 8];
+static byte *vis_rows;
+static cvar_t *map_viscache;
+static int *vis_keyslot;
+static int vis_lookups, vis_hits, vis_decompressions;
+static int vis_mru, vis_lru;
+static int vis_numslots;
+static int vis_rowsize;
+static qboolean vis_expanded;
+static visslot_t *vis_slots;
+
+static void CM_InitVisCache(void);
 
 #ifndef DEDICATED_ONLY
 int		c_pointcontents;
@@ -385,31 +447,61 @@ CM_InitBoxHull(void)
 	}
 }
 
+/*
+ * Returns the context's copy of a box hull plane.
+ */
+static cplane_t *
+CM_BoxPlane(cmtrace_t *ctx, cplane_t *plane)
+{
+	if (ctx->boxplanes)
+	{
+		return ctx->boxplanes + (plane - box_planes);
+	}
+
+	return plane;
+}
+
 /*
  * To keep everything totally uniform, bounding boxes are turned into
- * small BSP trees instead of being compared directly.
+ * small BSP trees instead of being compared directly. The planes are
+ * private to the context, so each thread can have its own box.
  */
 int
-CM_HeadnodeForBox(vec3_t mins, vec3_t maxs)
+CM_HeadnodeForBoxContext(cmtrace_t *ctx, vec3_t mins, vec3_t maxs)
 {
-	box_planes[0].dist = maxs[0];
-	box_planes[1].dist = -maxs[0];
-	box_planes[2].dist = mins[0];
-	box_planes[3].dist = -mins[0];
-	box_planes[4].dist = maxs[1];
-	box_planes[5].dist = -maxs[1];
-	box_planes[6].dist = mins[1];
-	box_planes[7].dist = -mins[1];
-	box_planes[8].dist = maxs[2];
-	box_planes[9].dist = -maxs[2];
-	box_planes[10].dist = mins[2];
-	box_planes[11].dist = -mins[2];
+	cplane_t *p;
+
+	if (ctx->boxplanes)
+	{
+		memcpy(ctx->boxplanes, box_planes, sizeof(ctx->ownboxplanes));
+	}
+
+	p = CM_BoxPlane(ctx, box_planes);
+
+	p[0].dist = maxs[0];
+	p[1].dist = -maxs[0];
+	p[2].dist = mins[0];
+	p[3].dist = -mins[0];
+	p[4].dist = maxs[1];
+	p[5].dist = -maxs[1];
+	p[6].dist = mins[1];
+	p[7].dist = -mins[1];
+	p[8].dist = maxs[2];
+	p[9].dist = -maxs[2];
+	p[10].dist = mins[2];
+	p[11].dist = -mins[2];
 
 	return box_headnode;
 }
 
 int
-CM_PointLeafnum_r(vec3_t p, int num)
+CM_HeadnodeForBox(vec3_t mins, vec3_t maxs)
+{
+	return CM_HeadnodeForBoxContext(&cm_trace, mins, maxs);
+}
+
+static int
+CM_PointLeafnumContext_r(cmtrace_t *ctx, vec3_t p, int num)
 {
 	float d;
 	cnode_t *node;
@@ -420,6 +512,11 @@ CM_PointLeafnum_r(vec3_t p, int num)
 		node = map_nodes + num;
 		plane = node->plane;
 
+		if (num >= box_headnode)
+		{
+			plane = CM_BoxPlane(ctx, plane);
+		}
+
 		if (plane->type < 3)
 		{
 			d = p[plane->type] - plane->dist;
@@ -448,6 +545,12 @@ CM_PointLeafnum_r(vec3_t p, int num)
 	return -1 - num;
 }
 
+int
+CM_PointLeafnum_r(vec3_t p, int num)
+{
+	return CM_PointLeafnumContext_r(&cm_trace, p, num);
+}
+
 int
 CM_PointLeafnum(vec3_t p)
 {
@@ -462,9 +565,8 @@ CM_PointLeafnum(vec3_t p)
 /*
  * Fills in a list of all the leafs touched
  */
-
-void
-CM_BoxLeafnums_r(int nodenum)
+static void
+CM_BoxLeafnums_r(leafquery_t *q, int nodenum)
 {
 	cplane_t *plane;
 	cnode_t *node;
@@ -474,18 +576,24 @@ CM_BoxLeafnums_r(int nodenum)
 	{
 		if (nodenum < 0)
 		{
-			if (leaf_count >= leaf_maxcount)
+			if (q->count >= q->maxcount)
 			{
 				return;
 			}
 
-			leaf_list[leaf_count++] = -1 - nodenum;
+			q->list[q->count++] = -1 - nodenum;
 			return;
 		}
 
 		node = &map_nodes[nodenum];
 		plane = node->plane;
-		s = BOX_ON_PLANE_SIDE(leaf_mins, leaf_maxs, plane);
+
+		if (nodenum >= box_headnode)
+		{
+			plane = CM_BoxPlane(q->ctx, plane);
+		}
+
+		s = BOX_ON_PLANE_SIDE(q->mins, q->maxs, plane);
 
 		if (s == 1)
 		{
@@ -500,37 +608,48 @@ CM_BoxLeafnums_r(int nodenum)
 		else
 		{
 			/* go down both */
-			if (leaf_topnode == -1)
+			if (q->topnode == -1)
 			{
-				leaf_topnode = nodenum;
+				q->topnode = nodenum;
 			}
 
-			CM_BoxLeafnums_r(node->children[0]);
+			CM_BoxLeafnums_r(q, node->children[0]);
 			nodenum = node->children[1];
 		}
 	}
 }
 
-int
-CM_BoxLeafnums_headnode(vec3_t mins, vec3_t maxs, int *list,
+static int
+CM_BoxLeafnumsContext(cmtrace_t *ctx, vec3_t mins, vec3_t maxs, int *list,
 		int listsize, int headnode, int *topnode)
 {
-	leaf_list = list;
-	leaf_count = 0;
-	leaf_maxcount = listsize;
-	leaf_mins = mins;
-	leaf_maxs = maxs;
+	leafquery_t q;
+
+	q.ctx = ctx;
+	q.list = list;
+	q.count = 0;
+	q.maxcount = listsize;
+	q.mins = mins;
+	q.maxs = maxs;
 
-	leaf_topnode = -1;
+	q.topnode = -1;
 
-	CM_BoxLeafnums_r(headnode);
+	CM_BoxLeafnums_r(&q, headnode);
 
 	if (topnode)
 	{
-		*topnode = leaf_topnode;
+		*topnode = q.topnode;
 	}
 
-	return leaf_count;
+	return q.count;
+}
+
+int
+CM_BoxLeafnums_headnode(vec3_t mins, vec3_t maxs, int *list,
+		int listsize, int headnode, int *topnode)
+{
+	return CM_BoxLeafnumsContext(&cm_trace, mins, maxs, list,
+			listsize, headnode, topnode);
 }
 
 int
@@ -560,7 +679,7 @@ CM_PointContents(vec3_t p, int headnode)
  * rotating entities
  */
 int
-CM_TransformedPointContents(vec3_t p, int headnode,
+CM_TransformedPointContentsContext(cmtrace_t *ctx, vec3_t p, int headnode,
 		vec3_t origin, vec3_t angles)
 {
 	vec3_t p_l;
@@ -583,14 +702,21 @@ CM_TransformedPointContents(vec3_t p, int headnode,
 		p_l[2] = DotProduct(temp, up);
 	}
 
-	l = CM_PointLeafnum_r(p_l, headnode);
+	l = CM_PointLeafnumContext_r(ctx, p_l, headnode);
 
 	return map_leafs[l].contents;
 }
 
-void
-CM_ClipBoxToBrush(vec3_t mins, vec3_t maxs, vec3_t p1,
-		vec3_t p2, trace_t *trace, cbrush_t *brush)
+int
+CM_TransformedPointContents(vec3_t p, int headnode,
+		vec3_t origin, vec3_t angles)
+{
+	return CM_TransformedPointContentsContext(&cm_trace, p, headnode,
+			origin, angles);
+}
+
+static void
+CM_ClipBoxToBrushScalar(cmtrace_t *ctx, cbrush_t *brush)
 {
 	int i, j;
 	cplane_t *plane, *clipplane;
@@ -601,19 +727,12 @@ CM_ClipBoxToBrush(vec3_t mins, vec3_t maxs, vec3_t p1,
 	qboolean getout, startout;
 	float f;
 	cbrushside_t *side, *leadside;
+	trace_t *trace;
 
 	enterfrac = -1;
 	leavefrac = 1;
 	clipplane = NULL;
-
-	if (!brush->numsides)
-	{
-		return;
-	}
-
-#ifndef DEDICATED_ONLY
-	c_brush_traces++;
-#endif
+	trace = &ctx->trace;
 
 	getout = false;
 	startout = false;
@@ -624,7 +743,12 @@ CM_ClipBoxToBrush(vec3_t mins, vec3_t maxs, vec3_t p1,
 		side = &map_brushsides[brush->firstbrushside + i];
 		plane = side->plane;
 
-		if (!trace_ispoint)
+		if (brush == box_brush)
+		{
+			plane = CM_BoxPlane(ctx, plane);
+		}
+
+		if (!ctx->ispoint)
 		{
 			/* general box case
 			   push the plane out
@@ -633,12 +757,12 @@ CM_ClipBoxToBrush(vec3_t mins, vec3_t maxs, vec3_t p1,
 			{
 				if (plane->normal[j] < 0)
 				{
-					ofs[j] = maxs[j];
+					ofs[j] = ctx->maxs[j];
 				}
 
 				else
 				{
-					ofs[j] = mins[j];
+					ofs[j] = ctx->mins[j];
 				}
 			}
 
@@ -652,8 +776,8 @@ CM_ClipBoxToBrush(vec3_t mins, vec3_t maxs, vec3_t p1,
 			dist = plane->dist;
 		}
 
-		d1 = DotProduct(p1, plane->normal) - dist;
-		d2 = DotProduct(p2, plane->normal) - dist;
+		d1 = DotProduct(ctx->start, plane->normal) - dist;
+		d2 = DotProduct(ctx->end, plane->normal) - dist;
 
 		if (d2 > 0)
 		{
@@ -737,9 +861,8 @@ CM_ClipBoxToBrush(vec3_t mins, vec3_t maxs, vec3_t p1,
 	}
 }
 
-void
-CM_TestBoxInBrush(vec3_t mins, vec3_t maxs, vec3_t p1, 
-		trace_t *trace, cbrush_t *brush)
+static qboolean
+CM_TestBoxInBrushScalar(cmtrace_t *ctx, cbrush_t *brush)
 {
 	int i, j;
 	cplane_t *plane;
@@ -748,16 +871,16 @@ CM_TestBoxInBrush(vec3_t mins, vec3_t maxs, vec3_t p1,
 	float d1;
 	cbrushside_t *side;
 
-	if (!brush->numsides)
-	{
-		return;
-	}
-
 	for (i = 0; i < brush->numsides; i++)
 	{
 		side = &map_brushsides[brush->firstbrushside + i];
 		plane = side->plane;
 
+		if (brush == box_brush)
+		{
+			plane = CM_BoxPlane(ctx, plane);
+		}
+
 		/* general box case
 		   push the plane out
 		   apropriately for mins/maxs */
@@ -765,35 +888,371 @@ CM_TestBoxInBrush(vec3_t mins, vec3_t maxs, vec3_t p1,
 		{
 			if (plane->normal[j] < 0)
 			{
-				ofs[j] = maxs[j];
+				ofs[j] = ctx->maxs[j];
 			}
 
 			else
 			{
-				ofs[j] = mins[j];
+				ofs[j] = ctx->mins[j];
 			}
 		}
 
 		dist = DotProduct(ofs, plane->normal);
 		dist = plane->dist - dist;
 
-		d1 = DotProduct(p1, plane->normal) - dist;
+		d1 = DotProduct(ctx->start, plane->normal) - dist;
 
 		/* if completely in front of face, no intersection */
 		if (d1 > 0)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+#ifdef CM_SIMD
+/*
+ * The SIMD versions of the above. They walk map_brushsoa four
+ * sides at a time, with the very same float operations in the
+ * same order, so the results are bit for bit the scalar ones.
+ * map_simdclip 2 runs both and complains about differences.
+ */
+
+/*
+ * Picks maxs where the normal is negative, mins otherwise
+ */
+static __m128
+CM_SelectOffset(__m128 normal, float mins, float maxs)
+{
+	__m128 mask;
+
+	mask = _mm_cmplt_ps(normal, _mm_setzero_ps());
+
+	return _mm_or_ps(_mm_and_ps(mask, _mm_set1_ps(maxs)),
+			_mm_andnot_ps(mask, _mm_set1_ps(mins)));
+}
+
+/*
+ * The plane distances of four sides, pushed
+ * out apropriately for the box mins/maxs
+ */
+static __m128
+CM_PushPlanes(cmtrace_t *ctx, cbrushsoa_t *soa)
+{
+	__m128 nx, ny, nz, ofs;
+
+	nx = _mm_loadu_ps(soa->normal[0]);
+	ny = _mm_loadu_ps(soa->normal[1]);
+	nz = _mm_loadu_ps(soa->normal[2]);
+
+	ofs = _mm_add_ps(_mm_add_ps(
+			_mm_mul_ps(CM_SelectOffset(nx, ctx->mins[0], ctx->maxs[0]), nx),
+			_mm_mul_ps(CM_SelectOffset(ny, ctx->mins[1], ctx->maxs[1]), ny)),
+			_mm_mul_ps(CM_SelectOffset(nz, ctx->mins[2], ctx->maxs[2]), nz));
+
+	return _mm_sub_ps(_mm_loadu_ps(soa->dist), ofs);
+}
+
+/*
+ * DotProduct(p, normal) - dist for four sides
+ */
+static __m128
+CM_PlaneDistances(cbrushsoa_t *soa, vec3_t p, __m128 dist)
+{
+	return _mm_sub_ps(_mm_add_ps(_mm_add_ps(
+			_mm_mul_ps(_mm_set1_ps(p[0]), _mm_loadu_ps(soa->normal[0])),
+			_mm_mul_ps(_mm_set1_ps(p[1]), _mm_loadu_ps(soa->normal[1]))),
+			_mm_mul_ps(_mm_set1_ps(p[2]), _mm_loadu_ps(soa->normal[2]))), dist);
+}
+
+static void
+CM_ClipBoxToBrushSIMD(cmtrace_t *ctx, cbrush_t *brush)
+{
+	int i, j, n;
+	cbrushsoa_t *soa;
+	cbrushside_t *side;
+	__m128 dist, v1, v2;
+	float d1[4], d2[4];
+	float enterfrac, leavefrac;
+	qboolean getout, startout;
+	float f;
+	int leadside;
+	trace_t *trace;
+
+	enterfrac = -1;
+	leavefrac = 1;
+	leadside = -1;
+	trace = &ctx->trace;
+
+	getout = false;
+	startout = false;
+
+	soa = &map_brushsoa[brush->firstsoa];
+
+	for (i = 0; i < brush->numsides; i += 4, soa++)
+	{
+		if (!ctx->ispoint)
+		{
+			dist = CM_PushPlanes(ctx, soa);
+		}
+
+		else
+		{
+			/* special point case */
+			dist = _mm_loadu_ps(soa->dist);
+		}
+
+		v1 = CM_PlaneDistances(soa, ctx->start, dist);
+		v2 = CM_PlaneDistances(soa, ctx->end, dist);
+
+		/* if completely in front of any face, no intersection.
+		   The zero padding planes never are. */
+		if (_mm_movemask_ps(_mm_and_ps(_mm_cmpgt_ps(v1, _mm_setzero_ps()),
+						_mm_cmpge_ps(v2, v1))))
 		{
 			return;
 		}
+
+		_mm_storeu_ps(d1, v1);
+		_mm_storeu_ps(d2, v2);
+
+		n = brush->numsides - i;
+
+		if (n > 4)
+		{
+			n = 4;
+		}
+
+		for (j = 0; j < n; j++)
+		{
+			if (d2[j] > 0)
+			{
+				getout = true; /* endpoint is not in solid */
+			}
+
+			if (d1[j] > 0)
+			{
+				startout = true;
+			}
+
+			if ((d1[j] <= 0) && (d2[j] <= 0))
+			{
+				continue;
+			}
+
+			/* crosses face */
+			if (d1[j] > d2[j])
+			{
+				/* enter */
+				f = (d1[j] - DIST_EPSILON) / (d1[j] - d2[j]);
+
+				if (f > enterfrac)
+				{
+					enterfrac = f;
+					leadside = i + j;
+				}
+			}
+
+			else
+			{
+				/* leave */
+				f = (d1[j] + DIST_EPSILON) / (d1[j] - d2[j]);
+
+				if (f < leavefrac)
+				{
+					leavefrac = f;
+				}
+			}
+		}
+	}
+
+	if (!startout)
+	{
+		/* original point was inside brush */
+		trace->startsolid = true;
+
+		if (!getout)
+		{
+			trace->allsolid = true;
+		}
+
+		return;
+	}
+
+	if (enterfrac < leavefrac)
+	{
+		if ((enterfrac > -1) && (enterfrac < trace->fraction))
+		{
+			if (enterfrac < 0)
+			{
+				enterfrac = 0;
+			}
+
+			if (leadside == -1)
+			{
+				Com_Error(ERR_FATAL, "clipplane was NULL!\n");
+			}
+
+			side = &map_brushsides[brush->firstbrushside + leadside];
+
+			trace->fraction = enterfrac;
+			trace->plane = *side->plane;
+			trace->surface = &(side->surface->c);
+			trace->contents = brush->contents;
+		}
+	}
+}
+
+static qboolean
+CM_TestBoxInBrushSIMD(cmtrace_t *ctx, cbrush_t *brush)
+{
+	int i;
+	cbrushsoa_t *soa;
+	__m128 d1;
+
+	soa = &map_brushsoa[brush->firstsoa];
+
+	for (i = 0; i < brush->numsides; i += 4, soa++)
+	{
+		d1 = CM_PlaneDistances(soa, ctx->start, CM_PushPlanes(ctx, soa));
+
+		/* if completely in front of face, no intersection */
+		if (_mm_movemask_ps(_mm_cmpgt_ps(d1, _mm_setzero_ps())))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/*
+ * Returns true if the two traces differ in any
+ * field CM_ClipBoxToBrush() may change.
+ */
+static qboolean
+CM_TracesDiffer(trace_t *a, trace_t *b)
+{
+	return (a->allsolid != b->allsolid) ||
+		   (a->startsolid != b->startsolid) ||
+		   (a->fraction != b->fraction) ||
+		   (a->contents != b->contents) ||
+		   (a->surface != b->surface) ||
+		   !VectorCompare(a->plane.normal, b->plane.normal) ||
+		   (a->plane.dist != b->plane.dist);
+}
+#endif
+
+static void
+CM_ClipBoxToBrush(cmtrace_t *ctx, cbrush_t *brush)
+{
+#ifdef CM_SIMD
+	trace_t before, scalar;
+#endif
+
+	if (!brush->numsides)
+	{
+		return;
+	}
+
+#ifndef DEDICATED_ONLY
+	c_brush_traces++;
+#endif
+
+#ifdef CM_SIMD
+	/* the box brush has per context planes */
+	if ((brush != box_brush) && (brush->firstsoa != -1) &&
+		map_simdclip && map_simdclip->value)
+	{
+		if (map_simdclip->value == 2)
+		{
+			before = ctx->trace;
+			CM_ClipBoxToBrushScalar(ctx, brush);
+			scalar = ctx->trace;
+			ctx->trace = before;
+			CM_ClipBoxToBrushSIMD(ctx, brush);
+
+			if (CM_TracesDiffer(&scalar, &ctx->trace))
+			{
+				Com_Printf("CM_ClipBoxToBrush: SIMD mismatch on brush %i\n",
+						(int)(brush - map_brushes));
+			}
+		}
+		else
+		{
+			CM_ClipBoxToBrushSIMD(ctx, brush);
+		}
+
+		return;
+	}
+#endif
+
+	CM_ClipBoxToBrushScalar(ctx, brush);
+}
+
+static void
+CM_TestBoxInBrush(cmtrace_t *ctx, cbrush_t *brush)
+{
+	qboolean inside;
+	trace_t *trace;
+
+	if (!brush->numsides)
+	{
+		return;
+	}
+
+#ifdef CM_SIMD
+	if ((brush != box_brush) && (brush->firstsoa != -1) &&
+		map_simdclip && map_simdclip->value)
+	{
+		inside = CM_TestBoxInBrushSIMD(ctx, brush);
+
+		if ((map_simdclip->value == 2) &&
+			(inside != CM_TestBoxInBrushScalar(ctx, brush)))
+		{
+			Com_Printf("CM_TestBoxInBrush: SIMD mismatch on brush %i\n",
+					(int)(brush - map_brushes));
+		}
+	}
+	else
+#endif
+	{
+		inside = CM_TestBoxInBrushScalar(ctx, brush);
+	}
+
+	if (!inside)
+	{
+		return;
 	}
 
 	/* inside this brush */
+	trace = &ctx->trace;
 	trace->startsolid = trace->allsolid = true;
 	trace->fraction = 0;
 	trace->contents = brush->contents;
 }
 
-void
-CM_TraceToLeaf(int leafnum)
+/*
+ * Returns true if the brush was already tested
+ * by this trace, in another leaf.
+ */
+static qboolean
+CM_BrushChecked(cmtrace_t *ctx, int brushnum)
+{
+	if (ctx->brushcheck[brushnum] == ctx->checkcount)
+	{
+		return true;
+	}
+
+	ctx->brushcheck[brushnum] = ctx->checkcount;
+
+	return false;
+}
+
+static void
+CM_TraceToLeaf(cmtrace_t *ctx, int leafnum)
 {
 	int k;
 	int brushnum;
@@ -802,7 +1261,7 @@ CM_TraceToLeaf(int leafnum)
 
 	leaf = &map_leafs[leafnum];
 
-	if (!(leaf->contents & trace_contents))
+	if (!(leaf->contents & ctx->contents))
 	{
 		return;
 	}
@@ -813,30 +1272,27 @@ CM_TraceToLeaf(int leafnum)
 		brushnum = map_leafbrushes[leaf->firstleafbrush + k];
 		b = &map_brushes[brushnum];
 
-		if (b->checkcount == checkcount)
+		if (CM_BrushChecked(ctx, brushnum))
 		{
 			continue; /* already checked this brush in another leaf */
 		}
 
-		b->checkcount = checkcount;
-
-		if (!(b->contents & trace_contents))
+		if (!(b->contents & ctx->contents))
 		{
 			continue;
 		}
 
-		CM_ClipBoxToBrush(trace_mins, trace_maxs, trace_start,
-				trace_end, &trace_trace, b);
+		CM_ClipBoxToBrush(ctx, b);
 
-		if (!trace_trace.fraction)
+		if (!ctx->trace.fraction)
 		{
 			return;
 		}
 	}
 }
 
-void
-CM_TestInLeaf(int leafnum)
+static void
+CM_TestInLeaf(cmtrace_t *ctx, int leafnum)
 {
 	int k;
 	int brushnum;
@@ -845,7 +1301,7 @@ CM_TestInLeaf(int leafnum)
 
 	leaf = &map_leafs[leafnum];
 
-	if (!(leaf->contents & trace_contents))
+	if (!(leaf->contents & ctx->contents))
 	{
 		return;
 	}
@@ -856,29 +1312,28 @@ CM_TestInLeaf(int leafnum)
 		brushnum = map_leafbrushes[leaf->firstleafbrush + k];
 		b = &map_brushes[brushnum];
 
-		if (b->checkcount == checkcount)
+		if (CM_BrushChecked(ctx, brushnum))
 		{
 			continue; /* already checked this brush in another leaf */
 		}
 
-		b->checkcount = checkcount;
-
-		if (!(b->contents & trace_contents))
+		if (!(b->contents & ctx->contents))
 		{
 			continue;
 		}
 
-		CM_TestBoxInBrush(trace_mins, trace_maxs, trace_start, &trace_trace, b);
+		CM_TestBoxInBrush(ctx, b);
 
-		if (!trace_trace.fraction)
+		if (!ctx->trace.fraction)
 		{
 			return;
 		}
 	}
 }
 
-void
-CM_RecursiveHullCheck(int num, float p1f, float p2f, vec3_t p1, vec3_t p2)
+static void
+CM_RecursiveHullCheck(cmtrace_t *ctx, int num, float p1f, float p2f,
+		vec3_t p1, vec3_t p2)
 {
 	cnode_t *node;
 	cplane_t *plane;
@@ -890,7 +1345,7 @@ CM_RecursiveHullCheck(int num, float p1f, float p2f, vec3_t p1, vec3_t p2)
 	int side;
 	float midf;
 
-	if (trace_trace.fraction <= p1f)
+	if (ctx->trace.fraction <= p1f)
 	{
 		return; /* already hit something nearer */
 	}
@@ -898,7 +1353,7 @@ CM_RecursiveHullCheck(int num, float p1f, float p2f, vec3_t p1, vec3_t p2)
 	/* if < 0, we are in a leaf node */
 	if (num < 0)
 	{
-		CM_TraceToLeaf(-1 - num);
+		CM_TraceToLeaf(ctx, -1 - num);
 		return;
 	}
 
@@ -907,11 +1362,16 @@ CM_RecursiveHullCheck(int num, float p1f, float p2f, vec3_t p1, vec3_t p2)
 	node = map_nodes + num;
 	plane = node->plane;
 
+	if (num >= box_headnode)
+	{
+		plane = CM_BoxPlane(ctx, plane);
+	}
+
 	if (plane->type < 3)
 	{
 		t1 = p1[plane->type] - plane->dist;
 		t2 = p2[plane->type] - plane->dist;
-		offset = trace_extents[plane->type];
+		offset = ctx->extents[plane->type];
 	}
 
 	else
@@ -919,29 +1379,29 @@ CM_RecursiveHullCheck(int num, float p1f, float p2f, vec3_t p1, vec3_t p2)
 		t1 = DotProduct(plane->normal, p1) - plane->dist;
 		t2 = DotProduct(plane->normal, p2) - plane->dist;
 
-		if (trace_ispoint)
+		if (ctx->ispoint)
 		{
 			offset = 0;
 		}
 
 		else
 		{
-			offset = (float)fabs(trace_extents[0] * plane->normal[0]) +
-					 (float)fabs(trace_extents[1] * plane->normal[1]) +
-					 (float)fabs(trace_extents[2] * plane->normal[2]);
+			offset = (float)fabs(ctx->extents[0] * plane->normal[0]) +
+					 (float)fabs(ctx->extents[1] * plane->normal[1]) +
+					 (float)fabs(ctx->extents[2] * plane->normal[2]);
 		}
 	}
 
 	/* see which sides we need to consider */
 	if ((t1 >= offset) && (t2 >= offset))
 	{
-		CM_RecursiveHullCheck(node->children[0], p1f, p2f, p1, p2);
+		CM_RecursiveHullCheck(ctx, node->children[0], p1f, p2f, p1, p2);
 		return;
 	}
 
 	if ((t1 < -offset) && (t2 < -offset))
 	{
-		CM_RecursiveHullCheck(node->children[1], p1f, p2f, p1, p2);
+		CM_RecursiveHullCheck(ctx, node->children[1], p1f, p2f, p1, p2);
 		return;
 	}
 
@@ -987,7 +1447,7 @@ CM_RecursiveHullCheck(int num, float p1f, float p2f, vec3_t p1, vec3_t p2)
 		mid[i] = p1[i] + frac * (p2[i] - p1[i]);
 	}
 
-	CM_RecursiveHullCheck(node->children[side], p1f, midf, p1, mid);
+	CM_RecursiveHullCheck(ctx, node->children[side], p1f, midf, p1, mid);
 
 	/* go past the node */
 	if (frac2 < 0)
@@ -1007,36 +1467,74 @@ CM_RecursiveHullCheck(int num, float p1f, float p2f, vec3_t p1, vec3_t p2)
 		mid[i] = p1[i] + frac2 * (p2[i] - p1[i]);
 	}
 
-	CM_RecursiveHullCheck(node->children[side ^ 1], midf, p2f, mid, p2);
+	CM_RecursiveHullCheck(ctx, node->children[side ^ 1], midf, p2f, mid, p2);
+}
+
+/*
+ * Allocates a context for traces on another thread. Must be
+ * called from the main thread, as the zone isn't thread safe.
+ */
+cmtrace_t *
+CM_NewTraceContext(void)
+{
+	cmtrace_t *ctx;
+
+	ctx = Z_Malloc(sizeof(cmtrace_t));
+	ctx->boxplanes = ctx->ownboxplanes;
+
+	return ctx;
+}
+
+void
+CM_FreeTraceContext(cmtrace_t *ctx)
+{
+	free(ctx->brushcheck);
+	Z_Free(ctx);
 }
 
 trace_t
-CM_BoxTrace(vec3_t start, vec3_t end, vec3_t mins, vec3_t maxs,
-		int headnode, int brushmask)
+CM_BoxTraceContext(cmtrace_t *ctx, vec3_t start, vec3_t end,
+		vec3_t mins, vec3_t maxs, int headnode, int brushmask)
 {
 	int i;
 
-	checkcount++; /* for multi-check avoidance */
+	/* one more for the box brush. realloc() and
+	   not the zone, this may run on any thread */
+	if (ctx->numbrushcheck < numbrushes + 1)
+	{
+		ctx->numbrushcheck = numbrushes + 1;
+		ctx->brushcheck = realloc(ctx->brushcheck,
+				ctx->numbrushcheck * sizeof(int));
+
+		if (!ctx->brushcheck)
+		{
+			Com_Error(ERR_FATAL, "CM_BoxTrace: out of memory");
+		}
+
+		memset(ctx->brushcheck, 0, ctx->numbrushcheck * sizeof(int));
+	}
+
+	ctx->checkcount++; /* for multi-check avoidance */
 
 #ifndef DEDICATED_ONLY
 	c_traces++; /* for statistics, may be zeroed */
 #endif
 
 	/* fill in a default trace */
-	memset(&trace_trace, 0, sizeof(trace_trace));
-	trace_trace.fraction = 1;
-	trace_trace.surface = &(nullsurface.c);
+	memset(&ctx->trace, 0, sizeof(ctx->trace));
+	ctx->trace.fraction = 1;
+	ctx->trace.surface = &(nullsurface.c);
 
 	if (!numnodes)  /* map not loaded */
 	{
-		return trace_trace;
+		return ctx->trace;
 	}
 
-	trace_contents = brushmask;
-	VectorCopy(start, trace_start);
-	VectorCopy(end, trace_end);
-	VectorCopy(mins, trace_mins);
-	VectorCopy(maxs, trace_maxs);
+	ctx->contents = brushmask;
+	VectorCopy(start, ctx->start);
+	VectorCopy(end, ctx->end);
+	VectorCopy(mins, ctx->mins);
+	VectorCopy(maxs, ctx->maxs);
 
 	/* check for position test special case */
 	if ((start[0] == end[0]) && (start[1] == end[1]) && (start[2] == end[2]))
@@ -1055,57 +1553,70 @@ CM_BoxTrace(vec3_t start, vec3_t end, vec3_t mins, vec3_t maxs,
 			c2[i] += 1;
 		}
 
-		numleafs = CM_BoxLeafnums_headnode(c1, c2, leafs, 1024,
+		numleafs = CM_BoxLeafnumsContext(ctx, c1, c2, leafs, 1024,
 				headnode, &topnode);
 
 		for (i = 0; i < numleafs; i++)
 		{
-			CM_TestInLeaf(leafs[i]);
+			CM_TestInLeaf(ctx, leafs[i]);
 
-			if (trace_trace.allsolid)
+			if (ctx->trace.allsolid)
 			{
 				break;
 			}
 		}
 
-		VectorCopy(start, trace_trace.endpos);
-		return trace_trace;
+		VectorCopy(start, ctx->trace.endpos);
+		return ctx->trace;
 	}
 
 	/* check for point special case */
 	if ((mins[0] == 0) && (mins[1] == 0) && (mins[2] == 0) &&
 		(maxs[0] == 0) && (maxs[1] == 0) && (maxs[2] == 0))
 	{
-		trace_ispoint = true;
-		VectorClear(trace_extents);
+		ctx->ispoint = true;
+		VectorClear(ctx->extents);
 	}
 
 	else
 	{
-		trace_ispoint = false;
-		trace_extents[0] = -mins[0] > maxs[0] ? -mins[0] : maxs[0];
-		trace_extents[1] = -mins[1] > maxs[1] ? -mins[1] : maxs[1];
-		trace_extents[2] = -mins[2] > maxs[2] ? -mins[2] : maxs[2];
+		ctx->ispoint = false;
+		ctx->extents[0] = -mins[0] > maxs[0] ? -mins[0] : maxs[0];
+		ctx->extents[1] = -mins[1] > maxs[1] ? -mins[1] : maxs[1];
+		ctx->extents[2] = -mins[2] > maxs[2] ? -mins[2] : maxs[2];
 	}
 
 	/* general sweeping through world */
-	CM_RecursiveHullCheck(headnode, 0, 1, start, end);
+	CM_RecursiveHullCheck(ctx, headnode, 0, 1, start, end);
 
-	if (trace_trace.fraction == 1)
+	if (ctx->trace.fraction == 1)
 	{
-		VectorCopy(end, trace_trace.endpos);
+		VectorCopy(end, ctx->trace.endpos);
 	}
 
 	else
 	{
 		for (i = 0; i < 3; i++)
 		{
-			trace_trace.endpos[i] = start[i] + trace_trace.fraction *
+			ctx->trace.endpos[i] = start[i] + ctx->trace.fraction *
 									(end[i] - start[i]);
 		}
 	}
 
-	return trace_trace;
+	return ctx->trace;
+}
+
+trace_t
+CM_BoxTrace(vec3_t start, vec3_t end, vec3_t mins, vec3_t maxs,
+		int headnode, int brushmask)
+{
+	if (cmb_recording)
+	{
+		CMB_RecordTrace(start, end, mins, maxs, headnode, brushmask);
+	}
+
+	return CM_BoxTraceContext(&cm_trace, start, end, mins, maxs,
+			headnode, brushmask);
 }
 
 /*
@@ -1113,8 +1624,9 @@ CM_BoxTrace(vec3_t start, vec3_t end, vec3_t mins, vec3_t maxs,
  * rotating entities
  */
 trace_t
-CM_TransformedBoxTrace(vec3_t start, vec3_t end, vec3_t mins, vec3_t maxs,
-		int headnode, int brushmask, vec3_t origin, vec3_t angles)
+CM_TransformedBoxTraceContext(cmtrace_t *ctx, vec3_t start, vec3_t end,
+		vec3_t mins, vec3_t maxs, int headnode, int brushmask,
+		vec3_t origin, vec3_t angles)
 {
 	trace_t trace;
 	vec3_t start_l, end_l;
@@ -1155,7 +1667,8 @@ CM_TransformedBoxTrace(vec3_t start, vec3_t end, vec3_t mins, vec3_t maxs,
 	}
 
 	/* sweep the box through the model */
-	trace = CM_BoxTrace(start_l, end_l, mins, maxs, headnode, brushmask);
+	trace = CM_BoxTraceContext(ctx, start_l, end_l, mins, maxs,
+			headnode, brushmask);
 
 	if (rotated && (trace.fraction != 1.0))
 	{
@@ -1175,6 +1688,14 @@ CM_TransformedBoxTrace(vec3_t start, vec3_t end, vec3_t mins, vec3_t maxs,
 	return trace;
 }
 
+trace_t
+CM_TransformedBoxTrace(vec3_t start, vec3_t end, vec3_t mins, vec3_t maxs,
+		int headnode, int brushmask, vec3_t origin, vec3_t angles)
+{
+	return CM_TransformedBoxTraceContext(&cm_trace, start, end, mins, maxs,
+			headnode, brushmask, origin, angles);
+}
+
 void
 CMod_LoadSubmodels(lump_t *l)
 {
@@ -1491,6 +2012,59 @@ CMod_LoadLeafBrushes(lump_t *l)
 	}
 }
 
+#ifdef CM_SIMD
+/*
+ * Copies the planes of every brush into map_brushsoa,
+ * padded with zero planes to a multiple of four sides.
+ */
+static void
+CMod_BuildBrushSoA(void)
+{
+	int i, j, numsoa;
+	cbrush_t *brush;
+	cbrushsoa_t *soa;
+	cplane_t *plane;
+
+	numsoa = 0;
+
+	for (i = 0; i < numbrushes; i++)
+	{
+		brush = &map_brushes[i];
+		brush->firstsoa = -1;
+
+		if ((brush->numsides <= 0) || (brush->firstbrushside < 0) ||
+			(brush->firstbrushside + brush->numsides > numbrushsides))
+		{
+			continue; /* broken, leave it to the scalar path */
+		}
+
+		/* brushes may share side ranges, so the sum
+		   can exceed the size of the table */
+		if (numsoa + (brush->numsides + 3) / 4 >
+			sizeof(map_brushsoa) / sizeof(map_brushsoa[0]))
+		{
+			continue;
+		}
+
+		brush->firstsoa = numsoa;
+		soa = &map_brushsoa[numsoa];
+		numsoa += (brush->numsides + 3) / 4;
+
+		memset(soa, 0, ((brush->numsides + 3) / 4) * sizeof(cbrushsoa_t));
+
+		for (j = 0; j < brush->numsides; j++)
+		{
+			plane = map_brushsides[brush->firstbrushside + j].plane;
+
+			soa[j / 4].normal[0][j % 4] = plane->normal[0];
+			soa[j / 4].normal[1][j % 4] = plane->normal[1];
+			soa[j / 4].normal[2][j % 4] = plane->normal[2];
+			soa[j / 4].dist[j % 4] = plane->dist;
+		}
+	}
+}
+#endif
+
 void
 CMod_LoadBrushSides(lump_t *l)
 {
@@ -1531,6 +2105,10 @@ CMod_LoadBrushSides(lump_t *l)
 
 		out->surface = &map_surfaces[j];
 	}
+
+#ifdef CM_SIMD
+	CMod_BuildBrushSoA();
+#endif
 }
 
 void
@@ -1635,6 +2213,7 @@ CM_LoadMap(char *name, qboolean clientload, unsigned *checksum)
 	static unsigned last_checksum;
 
 	map_noareas = Cvar_Get("map_noareas", "0", 0);
+	map_simdclip = Cvar_Get("map_simdclip", "1", 0);
 
 	if (!strcmp(map_name,
 				name) && (clientload || !Cvar_VariableValue("flushmap")))
@@ -1650,6 +2229,9 @@ CM_LoadMap(char *name, qboolean clientload, unsigned *checksum)
 		return &map_cmodels[0]; /* still have the right version */
 	}
 
+	/* recorded traces belong to one map */
+	cmb_recording = false;
+
 	/* free old stuff */
 	numplanes = 0;
 	numnodes = 0;
@@ -1666,10 +2248,11 @@ CM_LoadMap(char *name, qboolean clientload, unsigned *checksum)
 		numclusters = 1;
 		numareas = 1;
 		*checksum = 0;
+		CM_InitVisCache();
 		return &map_cmodels[0]; /* cinematic servers won't have anything at all */
 	}
 
-	length = FS_LoadFile(name, (void **)&buf);
+	length = FS_MapFile(name, (void **)&buf);
 
 	if (!buf)
 	{
@@ -1712,6 +2295,7 @@ CM_LoadMap(char *name, qboolean clientload, unsigned *checksum)
 	FS_FreeFile(buf);
 
 	CM_InitBoxHull();
+	CM_InitVisCache();
 
 	memset(portalopen, 0, sizeof(portalopen));
 	FloodAreaConnections();
@@ -1840,37 +2424,209 @@ CM_DecompressVis(byte *in, byte *out)
 	while (out_p - out < row);
 }
 
-byte *
-CM_ClusterPVS(int cluster)
+static void
+CM_FreeVisCache(void)
 {
-	if (cluster == -1)
+	if (vis_rows)
 	{
-		memset(pvsrow, 0, (numclusters + 7) >> 3);
+		Z_Free(vis_rows);
+		Z_Free(vis_slots);
+		Z_Free(vis_keyslot);
 	}
 
+	vis_rows = NULL;
+	vis_slots = NULL;
+	vis_keyslot = NULL;
+	vis_numslots = 0;
+}
+
+/*
+ * Sets up the decompressed vis row cache for the current map. If
+ * all PVS and PHS rows fit into map_viscache kilobytes they are
+ * expanded right away, otherwise that many rows are kept in an LRU.
+ */
+static void
+CM_InitVisCache(void)
+{
+	int i, rows, budget;
+
+	CM_FreeVisCache();
+
+	vis_lookups = 0;
+	vis_hits = 0;
+	vis_decompressions = 0;
+	vis_expanded = false;
+
+	map_viscache = Cvar_Get("map_viscache", "4096", CVAR_ARCHIVE);
+
+	/* rows are padded to whole ints for SV_FatPVS */
+	vis_rowsize = ((numclusters + 31) >> 5) << 2;
+	rows = numclusters * 2;
+
+	if (!rows)
+	{
+		return;
+	}
+
+	budget = (map_viscache->value > 0) ?
+		(int)(map_viscache->value * 1024 / vis_rowsize) : 0;
+
+	vis_expanded = (rows <= budget);
+
+	if (vis_expanded)
+	{
+		vis_numslots = rows;
+	}
 	else
 	{
-		CM_DecompressVis(map_visibility +
-				LittleLong(map_vis->bitofs[cluster][DVIS_PVS]), pvsrow);
+		vis_numslots = (budget > VIS_MINSLOTS) ? budget : VIS_MINSLOTS;
+
+		if (vis_numslots > rows)
+		{
+			vis_numslots = rows;
+		}
+	}
+
+	vis_rows = Z_Malloc(vis_numslots * vis_rowsize);
+	vis_slots = Z_Malloc(vis_numslots * sizeof(visslot_t));
+	vis_keyslot = Z_Malloc(rows * sizeof(int));
+
+	for (i = 0; i < rows; i++)
+	{
+		vis_keyslot[i] = -1;
 	}
 
-	return pvsrow;
+	for (i = 0; i < vis_numslots; i++)
+	{
+		vis_slots[i].key = -1;
+		vis_slots[i].prev = i - 1;
+		vis_slots[i].next = (i + 1 < vis_numslots) ? i + 1 : -1;
+	}
+
+	vis_mru = 0;
+	vis_lru = vis_numslots - 1;
+
+	if (vis_expanded)
+	{
+		for (i = 0; i < rows; i++)
+		{
+			vis_slots[i].key = i;
+			vis_keyslot[i] = i;
+			CM_DecompressVis(map_visibility +
+					LittleLong(map_vis->bitofs[i >> 1][i & 1]),
+					vis_rows + i * vis_rowsize);
+		}
+
+		vis_decompressions = rows;
+	}
 }
 
-byte *
-CM_ClusterPHS(int cluster)
+static void
+CM_TouchVisSlot(int slot)
 {
-	if (cluster == -1)
+	visslot_t *s;
+
+	if (slot == vis_mru)
 	{
-		memset(phsrow, 0, (numclusters + 7) >> 3);
+		return;
 	}
 
+	s = &vis_slots[slot];
+
+	/* unlink */
+	vis_slots[s->prev].next = s->next;
+
+	if (s->next != -1)
+	{
+		vis_slots[s->next].prev = s->prev;
+	}
 	else
 	{
-		CM_DecompressVis(map_visibility +
-				LittleLong(map_vis->bitofs[cluster][DVIS_PHS]), phsrow);
+		vis_lru = s->prev;
+	}
+
+	/* and put it in front */
+	s->prev = -1;
+	s->next = vis_mru;
+	vis_slots[vis_mru].prev = slot;
+	vis_mru = slot;
+}
+
+/*
+ * Returns the decompressed row. It stays valid until the next map
+ * load when the map is fully expanded and for at least VIS_MINSLOTS
+ * further lookups otherwise. The LRU isn't locked, threaded callers
+ * must hold Sys_JobLock.
+ */
+static byte *
+CM_ClusterVis(int cluster, int type)
+{
+	int key, slot;
+	byte *row;
+
+	if ((cluster < 0) || (cluster >= numclusters))
+	{
+		return vis_nullrow;
 	}
 
-	return phsrow;
+	vis_lookups++;
+
+	key = cluster * 2 + type;
+	slot = vis_keyslot[key];
+
+	if (slot != -1)
+	{
+		vis_hits++;
+
+		if (!vis_expanded)
+		{
+			CM_TouchVisSlot(slot);
+		}
+
+		return vis_rows + slot * vis_rowsize;
+	}
+
+	/* recycle the least recently used row */
+	slot = vis_lru;
+
+	if (vis_slots[slot].key != -1)
+	{
+		vis_keyslot[vis_slots[slot].key] = -1;
+	}
+
+	vis_slots[slot].key = key;
+	vis_keyslot[key] = slot;
+	CM_TouchVisSlot(slot);
+
+	row = vis_rows + slot * vis_rowsize;
+	CM_DecompressVis(map_visibility +
+			LittleLong(map_vis->bitofs[cluster][type]), row);
+	vis_decompressions++;
+
+	return row;
+}
+
+byte *
+CM_ClusterPVS(int cluster)
+{
+	return CM_ClusterVis(cluster, DVIS_PVS);
+}
+
+byte *
+CM_ClusterPHS(int cluster)
+{
+	return CM_ClusterVis(cluster, DVIS_PHS);
+}
+
+void
+CM_VisCacheStats(void)
+{
+	Com_Printf("mode          : %s\n", vis_expanded ? "expanded" : "lru");
+	Com_Printf("rows          : %i of %i (%i KB)\n", vis_numslots,
+			numclusters * 2, (vis_numslots * vis_rowsize) >> 10);
+	Com_Printf("lookups       : %i\n", vis_lookups);
+	Com_Printf("hits          : %i (%.1f%%)\n", vis_hits,
+			vis_lookups ? 100.0f * vis_hits / vis_lookups : 0.0f);
+	Com_Printf("decompressions: %i\n", vis_decompressions);
 }
 
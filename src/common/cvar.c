@@ -26,7 +26,32 @@
 
 #include "header/common.h"
 
-cvar_t *cvar_vars;
+#define CVAR_HASH_SIZE 256
+
+typedef struct cvarwatch_s
+{
+	cvarcallback_t callback;
+	struct cvarwatch_s *next;
+} cvarwatch_t;
+
+/* cvar_t is shared with the game, so the
+   buckets and subscriptions are kept aside */
+typedef struct cvarhash_s
+{
+	cvar_t *var;
+	struct cvarhash_s *next;
+	cvarwatch_t *watches;
+	qboolean changed; /* in cvar_changed */
+	struct cvarhash_s *nextChanged;
+} cvarhash_t;
+
+cvar_t *cvar_vars; /* sorted by name */
+static cvarhash_t *cvar_hash[CVAR_HASH_SIZE];
+static cvarhash_t *cvar_changed; /* waiting for Cvar_RunCallbacks() */
+
+/* names differing only in case share a
+   chain, the lookups compare with strcmp() */
+#define Cvar_HashName(name) (Q_strhash(name) & (CVAR_HASH_SIZE - 1))
 
 static qboolean
 Cvar_InfoValidate(char *s)
@@ -49,20 +74,125 @@ Cvar_InfoValidate(char *s)
 	return true;
 }
 
+static cvarhash_t *
+Cvar_FindHash(const char *var_name)
+{
+	cvarhash_t *h;
+
+	for (h = cvar_hash[Cvar_HashName(var_name)]; h; h = h->next)
+	{
+		if (!strcmp(var_name, h->var->name))
+		{
+			return h;
+		}
+	}
+
+	return NULL;
+}
+
 static cvar_t *
 Cvar_FindVar(const char *var_name)
 {
-	cvar_t *var;
+	cvarhash_t *h;
 
-	for (var = cvar_vars; var; var = var->next)
+	h = Cvar_FindHash(var_name);
+
+	return h ? h->var : NULL;
+}
+
+/*
+ * Queues the subscribers of a cvar whose value
+ * changed, they're run by Cvar_RunCallbacks().
+ */
+static void
+Cvar_Changed(cvar_t *var)
+{
+	cvarhash_t *h;
+
+	h = Cvar_FindHash(var->name);
+
+	if (!h || !h->watches || h->changed)
+	{
+		return;
+	}
+
+	h->changed = true;
+	h->nextChanged = cvar_changed;
+	cvar_changed = h;
+}
+
+void
+Cvar_Subscribe(cvar_t *var, cvarcallback_t callback)
+{
+	cvarhash_t *h;
+	cvarwatch_t *w;
+
+	h = Cvar_FindHash(var->name);
+
+	if (!h)
 	{
-		if (!strcmp(var_name, var->name))
+		return;
+	}
+
+	w = Z_Malloc(sizeof(*w));
+	w->callback = callback;
+	w->next = h->watches;
+	h->watches = w;
+
+	Cvar_Changed(var);
+}
+
+void
+Cvar_Unsubscribe(cvar_t *var, cvarcallback_t callback)
+{
+	cvarhash_t *h;
+	cvarwatch_t **back, *w;
+
+	h = Cvar_FindHash(var->name);
+
+	if (!h)
+	{
+		return;
+	}
+
+	for (back = &h->watches; *back; back = &w->next)
+	{
+		w = *back;
+
+		if (w->callback == callback)
 		{
-			return var;
+			*back = w->next;
+			Z_Free(w);
+			return;
 		}
 	}
+}
 
-	return NULL;
+/*
+ * Runs the subscribers of all cvars changed since the
+ * last call. Changes made by a callback are queued for
+ * the next call, so they can't loop.
+ */
+void
+Cvar_RunCallbacks(void)
+{
+	cvarhash_t *h, *next;
+	cvarwatch_t *w, *nextWatch;
+
+	h = cvar_changed;
+	cvar_changed = NULL;
+
+	for ( ; h; h = next)
+	{
+		next = h->nextChanged;
+		h->changed = false;
+
+		for (w = h->watches; w; w = nextWatch)
+		{
+			nextWatch = w->next;
+			w->callback(h->var);
+		}
+	}
 }
 
 float
@@ -109,12 +239,11 @@ Cvar_CompleteVariable(char *partial)
 	}
 
 	/* check exact match */
-	for (cvar = cvar_vars; cvar; cvar = cvar->next)
+	cvar = Cvar_FindVar(partial);
+
+	if (cvar)
 	{
-		if (!strcmp(partial, cvar->name))
-		{
-			return cvar->name;
-		}
+		return cvar->name;
 	}
 
 	/* check partial match */
@@ -138,6 +267,8 @@ Cvar_Get(char *var_name, char *var_value, int flags)
 {
 	cvar_t *var;
 	cvar_t **pos;
+	cvarhash_t *h;
+	unsigned hash;
 
 	if (flags & (CVAR_USERINFO | CVAR_SERVERINFO))
 	{
@@ -185,6 +316,12 @@ Cvar_Get(char *var_name, char *var_value, int flags)
 	var->next = *pos;
 	*pos = var;
 
+	hash = Cvar_HashName(var->name);
+	h = Z_Malloc(sizeof(*h));
+	h->var = var;
+	h->next = cvar_hash[hash];
+	cvar_hash[hash] = h;
+
 	var->flags = flags;
 
 	return var;
@@ -249,6 +386,7 @@ Cvar_Set2(char *var_name, char *value, qboolean force)
 			{
 				var->string = CopyString(value);
 				var->value = (float)strtod(var->string, (char **)NULL);
+				Cvar_Changed(var);
 
 				if (!strcmp(var->name, "game"))
 				{
@@ -286,6 +424,7 @@ Cvar_Set2(char *var_name, char *value, qboolean force)
 
 	var->string = CopyString(value);
 	var->value = strtod(var->string, (char **)NULL);
+	Cvar_Changed(var);
 
 	return var;
 }
@@ -325,6 +464,7 @@ Cvar_FullSet(char *var_name, char *value, int flags)
 
 	var->string = CopyString(value);
 	var->value = (float)strtod(var->string, (char **)NULL);
+	Cvar_Changed(var);
 
 	var->flags = flags;
 
@@ -368,6 +508,7 @@ Cvar_GetLatchedVars(void)
 		var->string = var->latched_string;
 		var->latched_string = NULL;
 		var->value = strtod(var->string, (char **)NULL);
+		Cvar_Changed(var);
 
 		if (!strcmp(var->name, "game"))
 		{
@@ -28,12 +28,18 @@
 #include "header/common.h"
 #include "../common/header/glob.h"
 
+#ifndef _WIN32
+ #include <sys/mman.h>
+ #include <unistd.h>
+#endif
+
 #ifdef ZIP
- #include "unzip/unzip.h"
+ #include <zlib.h>
 #endif
 
 #define MAX_HANDLES 512
 #define MAX_PAKS 100
+#define FS_HASH_SIZE 16384 /* buckets of the pack file index */
 
 #ifdef SYSTEMWIDE
  #ifndef SYSTEMDIR
@@ -41,15 +47,13 @@
  #endif
 #endif
 
-typedef struct
+typedef enum
 {
-	char name[MAX_QPATH];
-	fsMode_t mode;
-	FILE *file;           /* Only one will be used. */
+	PAK,
 #ifdef ZIP
-	unzFile *zip;        /* (file or zip) */
+	PK3
 #endif
-} fsHandle_t;
+} fsPackFormat_t;
 
 typedef struct fsLink_s
 {
@@ -59,24 +63,53 @@ typedef struct fsLink_s
 	struct fsLink_s *next;
 } fsLink_t;
 
-typedef struct
+typedef struct fsPackFile_s
 {
 	char name[MAX_QPATH];
 	int size;
-	int offset;     /* Ignored in PK3 files. */
+	int offset;     /* Start of the data, -1 until a PK3 local header was read. */
+#ifdef ZIP
+	int header;     /* Offset of the PK3 local header. */
+	int compressedSize;
+	int method;     /* PK3 compression method, 0 is stored. */
+#endif
+	unsigned hash;  /* Q_strhash(name) */
+	struct fsPack_s *pack;
+	struct fsPackFile_s *hashNext;
 } fsPackFile_t;
 
-typedef struct
+typedef struct fsPack_s
 {
 	char name[MAX_OSPATH];
 	int numFiles;
-	FILE *pak;
-#ifdef ZIP
-	unzFile *pk3;
-#endif
+	fsPackFormat_t format;
+	FILE *handle; /* Shared by all files read from the pack. */
 	fsPackFile_t *files;
 } fsPack_t;
 
+#ifdef ZIP
+/* State of a deflated PK3 file. */
+typedef struct
+{
+	z_stream stream;
+	int compressedPos;
+	byte buffer[8192];
+} fsInflate_t;
+#endif
+
+typedef struct
+{
+	char name[MAX_QPATH];
+	fsMode_t mode;
+	FILE *file;           /* Only one will be used. */
+	fsPack_t *pack;       /* (file or pack) */
+	fsPackFile_t *packFile;
+	int position;         /* Read position inside packFile. */
+#ifdef ZIP
+	fsInflate_t *inflate;
+#endif
+} fsHandle_t;
+
 typedef struct fsSearchPath_s
 {
 	char path[MAX_OSPATH]; /* Only one used. */
@@ -84,13 +117,18 @@ typedef struct fsSearchPath_s
 	struct fsSearchPath_s *next;
 } fsSearchPath_t;
 
-typedef enum
+#ifndef _WIN32
+/* A pack file mapped by FS_MapFile, shared by all its users. */
+typedef struct fsMapping_s
 {
-	PAK,
-#ifdef ZIP
-	PK3
+	fsPackFile_t *file; /* NULL once the pack was unmounted */
+	byte *base; /* page aligned start of the mapping */
+	size_t length;
+	byte *data;
+	int refs;
+	struct fsMapping_s *next;
+} fsMapping_t;
 #endif
-} fsPackFormat_t;
 
 typedef struct
 {
@@ -103,6 +141,13 @@ fsLink_t *fs_links;
 fsSearchPath_t *fs_searchPaths;
 fsSearchPath_t *fs_baseSearchPaths;
 
+/* The files of all mounted packs, hashed by lower case name. */
+static fsPackFile_t *fs_packHash[FS_HASH_SIZE];
+
+#ifndef _WIN32
+static fsMapping_t *fs_mappings;
+#endif
+
 /* Pack formats / suffixes. */
 fsPackTypes_t fs_packtypes[] = {
 	{"pak", PAK},
@@ -268,11 +313,7 @@ FS_HandleForFile(const char *path, fileHandle_t *f)
 
 	for (i = 0; i < MAX_HANDLES; i++, handle++)
 	{
-		if ((handle->file == NULL)
-#ifdef ZIP
-			 && (handle->zip == NULL)
-#endif
-			)
+		if ((handle->file == NULL) && (handle->pack == NULL))
 		{
 			Q_strlcpy(handle->name, path, sizeof(handle->name));
 			*f = i + 1;
@@ -382,10 +423,10 @@ FS_FCloseFile(fileHandle_t f)
 		fclose(handle->file);
 	}
 #ifdef ZIP
-	else if (handle->zip)
+	else if (handle->inflate)
 	{
-		unzCloseCurrentFile(handle->zip);
-		unzClose(handle->zip);
+		inflateEnd(&handle->inflate->stream);
+		Z_Free(handle->inflate);
 	}
 #endif
 
@@ -413,6 +454,271 @@ Developer_searchpath(int who)
 	return 0;
 }
 
+/*
+ * Adds all files of a newly mounted pack to the index. They are
+ * inserted backwards, so that the first of several files with the
+ * same name in one pack is found first, as with the linear search.
+ */
+static void
+FS_HashPack(fsPack_t *pack)
+{
+	fsPackFile_t *file;
+	int i;
+
+	for (i = pack->numFiles - 1; i >= 0; i--)
+	{
+		file = &pack->files[i];
+		file->hash = Q_strhash(file->name);
+		file->pack = pack;
+		file->hashNext = fs_packHash[file->hash & (FS_HASH_SIZE - 1)];
+		fs_packHash[file->hash & (FS_HASH_SIZE - 1)] = file;
+	}
+}
+
+static void
+FS_UnhashPack(fsPack_t *pack)
+{
+	fsPackFile_t **prev;
+	int i;
+
+	for (i = 0; i < pack->numFiles; i++)
+	{
+		prev = &fs_packHash[pack->files[i].hash & (FS_HASH_SIZE - 1)];
+
+		while (*prev)
+		{
+			if ((*prev)->pack == pack)
+			{
+				*prev = (*prev)->hashNext;
+			}
+			else
+			{
+				prev = &(*prev)->hashNext;
+			}
+		}
+	}
+}
+
+/*
+ * Returns the file in the given pack or NULL. Only the packs on the
+ * search path are in the index, so the caller still walks the path
+ * to get the precedence right.
+ */
+static fsPackFile_t *
+FS_FindPackFile(fsPack_t *pack, const char *name, unsigned hash)
+{
+	fsPackFile_t *file;
+
+	for (file = fs_packHash[hash & (FS_HASH_SIZE - 1)]; file; file = file->hashNext)
+	{
+		if ((file->pack == pack) && (file->hash == hash) &&
+			(Q_stricmp(file->name, name) == 0))
+		{
+			return file;
+		}
+	}
+
+	return NULL;
+}
+
+/*
+ * Positioned read from the pack's shared descriptor,
+ * so that no file has its own stdio state.
+ */
+static int
+FS_ReadPack(fsPack_t *pack, void *buffer, int size, int offset)
+{
+#ifdef _WIN32
+	if (fseek(pack->handle, offset, SEEK_SET) != 0)
+	{
+		return -1;
+	}
+
+	return fread(buffer, 1, size, pack->handle);
+#else
+	return pread(fileno(pack->handle), buffer, size, offset);
+#endif
+}
+
+#ifdef ZIP
+static int
+FS_ZipShort(const byte *p)
+{
+	return p[0] | (p[1] << 8);
+}
+
+static int
+FS_ZipLong(const byte *p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned)p[3] << 24);
+}
+
+/*
+ * Finds the start of the data behind the local header of a
+ * PK3 file. Done once per file, when it's first opened.
+ */
+static qboolean
+FS_ZipDataOffset(fsPack_t *pack, fsPackFile_t *file)
+{
+	byte header[30];
+
+	if (file->offset != -1)
+	{
+		return true;
+	}
+
+	if ((FS_ReadPack(pack, header, sizeof(header), file->header) != sizeof(header)) ||
+		(FS_ZipLong(header) != 0x04034b50))
+	{
+		return false;
+	}
+
+	file->offset = file->header + sizeof(header) +
+		FS_ZipShort(header + 26) + FS_ZipShort(header + 28);
+
+	return true;
+}
+#endif
+
+/*
+ * Points the handle to a file inside a pack.
+ */
+static qboolean
+FS_OpenPackFile(fsHandle_t *handle, fsPack_t *pack, fsPackFile_t *file)
+{
+#ifdef ZIP
+	if (pack->format == PK3)
+	{
+		if (!FS_ZipDataOffset(pack, file))
+		{
+			return false;
+		}
+
+		if (file->method == Z_DEFLATED)
+		{
+			handle->inflate = Z_Malloc(sizeof(fsInflate_t));
+
+			/* raw deflate data, zip has no zlib header */
+			if (inflateInit2(&handle->inflate->stream, -MAX_WBITS) != Z_OK)
+			{
+				Z_Free(handle->inflate);
+				handle->inflate = NULL;
+				return false;
+			}
+		}
+		else if (file->method != 0)
+		{
+			return false;
+		}
+	}
+#endif
+
+	handle->pack = pack;
+	handle->packFile = file;
+	handle->position = 0;
+
+	return true;
+}
+
+#ifdef ZIP
+static int
+FS_InflatePackFile(fsHandle_t *handle, byte *buffer, int size)
+{
+	fsInflate_t *z;
+	fsPackFile_t *file;
+	int r, err;
+
+	z = handle->inflate;
+	file = handle->packFile;
+
+	z->stream.next_out = buffer;
+	z->stream.avail_out = size;
+
+	while (z->stream.avail_out)
+	{
+		if (!z->stream.avail_in)
+		{
+			r = file->compressedSize - z->compressedPos;
+
+			if (r <= 0)
+			{
+				break;
+			}
+
+			if (r > sizeof(z->buffer))
+			{
+				r = sizeof(z->buffer);
+			}
+
+			r = FS_ReadPack(handle->pack, z->buffer, r,
+					file->offset + z->compressedPos);
+
+			if (r <= 0)
+			{
+				return -1;
+			}
+
+			z->compressedPos += r;
+			z->stream.next_in = z->buffer;
+			z->stream.avail_in = r;
+		}
+
+		err = inflate(&z->stream, Z_SYNC_FLUSH);
+
+		if (err == Z_STREAM_END)
+		{
+			break;
+		}
+
+		if (err != Z_OK)
+		{
+			return -1;
+		}
+	}
+
+	r = size - z->stream.avail_out;
+	handle->position += r;
+
+	return r;
+}
+#endif
+
+/*
+ * Reads from a file inside a pack, returns 0 at its end.
+ */
+static int
+FS_ReadPackFile(fsHandle_t *handle, void *buffer, int size)
+{
+	int r;
+
+	if (size > handle->packFile->size - handle->position)
+	{
+		size = handle->packFile->size - handle->position;
+	}
+
+	if (size <= 0)
+	{
+		return 0;
+	}
+
+#ifdef ZIP
+	if (handle->inflate)
+	{
+		return FS_InflatePackFile(handle, buffer, size);
+	}
+#endif
+
+	r = FS_ReadPack(handle->pack, buffer, size,
+			handle->packFile->offset + handle->position);
+
+	if (r > 0)
+	{
+		handle->position += r;
+	}
+
+	return r;
+}
+
 /*
  * Finds the file in the search path. Returns filesize and an open FILE *. Used
  * for streaming data out of either a pak file or a seperate file.
@@ -423,8 +729,9 @@ FS_FOpenFile(const char *name, fileHandle_t *f, qboolean gamedir_only)
 	char path[MAX_OSPATH];
 	fsHandle_t *handle;
 	fsPack_t *pack;
+	fsPackFile_t *file;
 	fsSearchPath_t *search;
-	int i;
+	unsigned hash;
 
 	file_from_pak = 0;
 #ifdef ZIP
@@ -434,6 +741,7 @@ FS_FOpenFile(const char *name, fileHandle_t *f, qboolean gamedir_only)
 	handle = FS_HandleForFile(name, f);
 	Q_strlcpy(handle->name, name, sizeof(handle->name));
 	handle->mode = FS_READ;
+	hash = Q_strhash(handle->name);
 
 	/* Search through the path, one element at a time. */
 	for (search = fs_searchPaths; search; search = search->next)
@@ -450,58 +758,38 @@ FS_FOpenFile(const char *name, fileHandle_t *f, qboolean gamedir_only)
 		if (search->pack)
 		{
 			pack = search->pack;
+			file = FS_FindPackFile(pack, handle->name, hash);
 
-			for (i = 0; i < pack->numFiles; i++)
+			if (file)
 			{
-				if (Q_stricmp(pack->files[i].name, handle->name) == 0)
+				/* Found it! */
+				Com_FilePath(pack->name, fs_fileInPath, sizeof(fs_fileInPath));
+				fs_fileInPack = true;
+
+				if (fs_debug->value)
+				{
+					Com_Printf("FS_FOpenFile: '%s' (found in '%s').\n",
+							   handle->name, pack->name);
+				}
+
+				if (pack->format == PAK)
 				{
-					/* Found it! */
-					Com_FilePath(pack->name, fs_fileInPath, sizeof(fs_fileInPath));
-					fs_fileInPack = true;
-
-					if (fs_debug->value)
-					{
-						Com_Printf("FS_FOpenFile: '%s' (found in '%s').\n",
-								   handle->name, pack->name);
-					}
-
-					if (pack->pak)
-					{
-						/* PAK */
-						file_from_pak = 1;
-						handle->file = fopen(pack->name, "rb");
-
-						if (handle->file)
-						{
-							fseek(handle->file, pack->files[i].offset, SEEK_SET);
-							return pack->files[i].size;
-						}
-					}
+					file_from_pak = 1;
+				}
 #ifdef ZIP
-					else if (pack->pk3)
-					{
-						/* PK3 */
-						file_from_pk3 = 1;
-						Q_strlcpy(file_from_pk3_name, strrchr(pack->name, '/') + 1, sizeof(file_from_pk3_name));
-						handle->zip = unzOpen(pack->name);
-
-						if (handle->zip)
-						{
-							if (unzLocateFile(handle->zip, handle->name, 2) == UNZ_OK)
-							{
-								if (unzOpenCurrentFile(handle->zip) == UNZ_OK)
-								{
-									return pack->files[i].size;
-								}
-							}
-
-							unzClose(handle->zip);
-						}
-					}
+				else
+				{
+					file_from_pk3 = 1;
+					Q_strlcpy(file_from_pk3_name, strrchr(pack->name, '/') + 1, sizeof(file_from_pk3_name));
+				}
 #endif
 
-					Com_Error(ERR_FATAL, "Couldn't reopen '%s'", pack->name);
+				if (FS_OpenPackFile(handle, pack, file))
+				{
+					return file->size;
 				}
+
+				Com_Error(ERR_FATAL, "Couldn't reopen '%s'", pack->name);
 			}
 		}
 		else
@@ -578,12 +866,10 @@ FS_Read(void *buffer, int size, fileHandle_t f)
 		{
 			r = fread(buf, 1, remaining, handle->file);
 		}
-#ifdef ZIP
-		else if (handle->zip)
+		else if (handle->pack)
 		{
-			r = unzReadCurrentFile(handle->zip, buf, remaining);
+			r = FS_ReadPackFile(handle, buf, remaining);
 		}
-#endif
 		else
 		{
 			return 0;
@@ -649,12 +935,10 @@ FS_FRead(void *buffer, int size, int count, fileHandle_t f)
 			{
 				r = fread(buf, 1, remaining, handle->file);
 			}
-#ifdef ZIP
-			else if (handle->zip)
+			else if (handle->pack)
 			{
-				r = unzReadCurrentFile(handle->zip, buf, remaining);
+				r = FS_ReadPackFile(handle, buf, remaining);
 			}
-#endif
 			else
 			{
 				return 0;
@@ -729,15 +1013,136 @@ FS_LoadFile(char *path, void **buffer)
 	return size;
 }
 
+#ifndef _WIN32
+/*
+ * Maps a file stored uncompressed in a pack. A file already
+ * mapped, like a BSP loaded by the collision model and by
+ * the renderer, is shared.
+ */
+static byte *
+FS_MapPackFile(fsPack_t *pack, fsPackFile_t *file)
+{
+	fsMapping_t *map;
+	long page;
+	int start;
+	void *base;
+
+	for (map = fs_mappings; map; map = map->next)
+	{
+		if (map->file == file)
+		{
+			map->refs++;
+			return map->data;
+		}
+	}
+
+	page = sysconf(_SC_PAGESIZE);
+	start = file->offset - (file->offset % page);
+
+	base = mmap(NULL, file->offset - start + file->size, PROT_READ,
+			MAP_PRIVATE, fileno(pack->handle), start);
+
+	if (base == MAP_FAILED)
+	{
+		return NULL;
+	}
+
+	map = Z_Malloc(sizeof(fsMapping_t));
+	map->file = file;
+	map->base = base;
+	map->length = file->offset - start + file->size;
+	map->data = map->base + (file->offset - start);
+	map->refs = 1;
+	map->next = fs_mappings;
+	fs_mappings = map;
+
+	return map->data;
+}
+#endif
+
+/*
+ * Returns a read-only view of files stored uncompressed in a pack,
+ * everything else is loaded like FS_LoadFile does.
+ */
+int
+FS_MapFile(char *path, void **buffer)
+{
+#ifndef _WIN32
+	byte *data;
+	int size;
+	fileHandle_t f;
+	fsHandle_t *handle;
+
+	size = FS_FOpenFile(path, &f, false);
+
+	if (size <= 0)
+	{
+		*buffer = NULL;
+		return size;
+	}
+
+	handle = FS_GetFileByHandle(f);
+
+	if (handle->pack
+#ifdef ZIP
+		&& !handle->inflate
+#endif
+		)
+	{
+		data = FS_MapPackFile(handle->pack, handle->packFile);
+
+		if (data)
+		{
+			FS_FCloseFile(f);
+			*buffer = data;
+			return size;
+		}
+	}
+
+	data = Z_Malloc(size);
+	*buffer = data;
+
+	FS_Read(data, size, f);
+	FS_FCloseFile(f);
+
+	return size;
+#else
+	return FS_LoadFile(path, buffer);
+#endif
+}
+
 void
 FS_FreeFile(void *buffer)
 {
+#ifndef _WIN32
+	fsMapping_t *map, **prev;
+#endif
+
 	if (buffer == NULL)
 	{
 		FS_DPrintf("FS_FreeFile: NULL buffer.\n");
 		return;
 	}
 
+#ifndef _WIN32
+	for (prev = &fs_mappings; *prev; prev = &(*prev)->next)
+	{
+		map = *prev;
+
+		if (map->data == buffer)
+		{
+			if (--map->refs == 0)
+			{
+				munmap(map->base, map->length);
+				*prev = map->next;
+				Z_Free(map);
+			}
+
+			return;
+		}
+	}
+#endif
+
 	Z_Free(buffer);
 }
 
@@ -800,13 +1205,13 @@ FS_LoadPAK(const char *packPath)
 
 	pack = Z_Malloc(sizeof(fsPack_t));
 	Q_strlcpy(pack->name, packPath, sizeof(pack->name));
-	pack->pak = handle;
-#ifdef ZIP
-	pack->pk3 = NULL;
-#endif
+	pack->format = PAK;
+	pack->handle = handle;
 	pack->numFiles = numFiles;
 	pack->files = files;
 
+	FS_HashPack(pack);
+
 	Com_Printf("Added packfile '%s' (%i files).\n", pack, numFiles);
 
 	return pack;
@@ -816,68 +1221,128 @@ FS_LoadPAK(const char *packPath)
 /*
  * Takes an explicit (not game tree related) path to a pack file.
  *
- * Loads the header and directory, adding the files at the beginning of the list
- * so they override previous pack files.
+ * Loads the central directory, adding the files at the beginning of the
+ * list so they override previous pack files. The local headers are read
+ * when a file is first opened.
  */
 fsPack_t *
 FS_LoadPK3(const char *packPath)
 {
-	char fileName[MAX_QPATH]; /* File name. */
-	int i = 0; /* Loop counter. */
+	byte *directory; /* Central directory. */
+	byte *entry; /* Current directory entry. */
+	byte tail[22 + 65535]; /* End of central directory and comment. */
+	int i; /* Loop counter. */
+	int length; /* Length of the pack. */
+	int nameLength; /* Length of a file name. */
 	int numFiles; /* Number of files in PK3. */
-	int status; /* Error indicator. */
+	int dirLength, dirOffset; /* Position of the central directory. */
+	int tailLength; /* Bytes read into tail. */
+	FILE *handle; /* File handle. */
 	fsPackFile_t *files; /* List of files in PK3. */
 	fsPack_t *pack; /* PK3 file. */
-	unzFile *handle; /* Zip file handle. */
-	unz_file_info info; /* Zip file info. */
-	unz_global_info global; /* Zip file global info. */
 
-	handle = unzOpen(packPath);
+	handle = fopen(packPath, "rb");
 
 	if (handle == NULL)
 	{
 		return NULL;
 	}
 
-	if (unzGetGlobalInfo(handle, &global) != UNZ_OK)
+	pack = Z_Malloc(sizeof(fsPack_t));
+	Q_strlcpy(pack->name, packPath, sizeof(pack->name));
+	pack->format = PK3;
+	pack->handle = handle;
+
+	/* Find the end of central directory record,
+	   it's followed by a comment of up to 64k. */
+	length = FS_FileLength(handle);
+	tailLength = (length < sizeof(tail)) ? length : sizeof(tail);
+
+	if (FS_ReadPack(pack, tail, tailLength, length - tailLength) != tailLength)
+	{
+		tailLength = 0;
+	}
+
+	for (i = tailLength - 22; i >= 0; i--)
+	{
+		if (FS_ZipLong(tail + i) == 0x06054b50)
+		{
+			break;
+		}
+	}
+
+	if (i < 0)
 	{
-		unzClose(handle);
+		fclose(handle);
+		Z_Free(pack);
 		Com_Error(ERR_FATAL, "FS_LoadPK3: '%s' is not a pack file", packPath);
 	}
 
-	numFiles = global.number_entry;
+	numFiles = FS_ZipShort(tail + i + 10);
+	dirLength = FS_ZipLong(tail + i + 12);
+	dirOffset = FS_ZipLong(tail + i + 16);
 
 	if ((numFiles > MAX_FILES_IN_PACK) || (numFiles == 0))
 	{
-		unzClose(handle);
+		fclose(handle);
+		Z_Free(pack);
 		Com_Error(ERR_FATAL, "FS_LoadPK3: '%s' has %i files",
 				packPath, numFiles);
 	}
 
+	directory = Z_Malloc(dirLength);
+
+	if (FS_ReadPack(pack, directory, dirLength, dirOffset) != dirLength)
+	{
+		dirLength = 0;
+	}
+
 	files = Z_Malloc(numFiles * sizeof(fsPackFile_t));
 
 	/* Parse the directory. */
-	status = unzGoToFirstFile(handle);
-
-	while (status == UNZ_OK)
+	for (i = 0, entry = directory; i < numFiles; i++)
 	{
-		fileName[0] = '\0';
-		unzGetCurrentFileInfo(handle, &info, fileName, MAX_QPATH,
-				NULL, 0, NULL, 0);
-		Q_strlcpy(files[i].name, fileName, sizeof(files[i].name));
-		files[i].offset = -1; /* Not used in ZIP files */
-		files[i].size = info.uncompressed_size;
-		i++;
-		status = unzGoToNextFile(handle);
+		if ((entry + 46 > directory + dirLength) ||
+			(FS_ZipLong(entry) != 0x02014b50) ||
+			(entry + 46 + FS_ZipShort(entry + 28) > directory + dirLength))
+		{
+			Z_Free(directory);
+			Z_Free(files);
+			fclose(handle);
+			Z_Free(pack);
+			Com_Error(ERR_FATAL, "FS_LoadPK3: '%s' has a broken directory",
+					packPath);
+		}
+
+		nameLength = FS_ZipShort(entry + 28);
+
+		if (nameLength >= sizeof(files[i].name))
+		{
+			nameLength = sizeof(files[i].name) - 1;
+		}
+
+		memcpy(files[i].name, entry + 46, nameLength);
+		files[i].name[nameLength] = '\0';
+
+		/* encrypted files can't be read */
+		files[i].method = (FS_ZipShort(entry + 8) & 1) ?
+			-1 : FS_ZipShort(entry + 10);
+		files[i].compressedSize = FS_ZipLong(entry + 20);
+		files[i].size = FS_ZipLong(entry + 24);
+		files[i].header = FS_ZipLong(entry + 42);
+		files[i].offset = -1;
+
+		entry += 46 + FS_ZipShort(entry + 28) + FS_ZipShort(entry + 30) +
+			FS_ZipShort(entry + 32);
 	}
 
-	pack = Z_Malloc(sizeof(fsPack_t));
-	Q_strlcpy(pack->name, packPath, sizeof(pack->name));
-	pack->pak = NULL;
-	pack->pk3 = handle;
+	Z_Free(directory);
+
 	pack->numFiles = numFiles;
 	pack->files = files;
 
+	FS_HashPack(pack);
+
 	Com_Printf("Added packfile '%s' (%i files).\n", pack, numFiles);
 
 	return pack;
@@ -1107,11 +1572,7 @@ FS_Path_f(void)
 
 	for (i = 0, handle = fs_handles; i < MAX_HANDLES; i++, handle++)
 	{
-		if ((handle->file != NULL)
-#ifdef ZIP
-			 || (handle->zip != NULL)
-#endif
-			)
+		if ((handle->file != NULL) || (handle->pack != NULL))
 		{
 			Com_Printf("Handle %i: '%s'.\n", i + 1, handle->name);
 		}
@@ -1165,6 +1626,9 @@ FS_SetGamedir(char *dir)
 {
 	int i;
 	fsSearchPath_t *next;
+#ifndef _WIN32
+	fsMapping_t *map;
+#endif
 
 	if (!*dir || !strcmp(dir, ".") || strstr(dir, "..") || strstr(dir, "/"))
 	{
@@ -1177,15 +1641,27 @@ FS_SetGamedir(char *dir)
 	{
 		if (fs_searchPaths->pack)
 		{
-			if (fs_searchPaths->pack->pak)
+			FS_UnhashPack(fs_searchPaths->pack);
+
+			/* Files read from the pack share its handle. */
+			for (i = 0; i < MAX_HANDLES; i++)
 			{
-				fclose(fs_searchPaths->pack->pak);
+				if (fs_handles[i].pack == fs_searchPaths->pack)
+				{
+					FS_FCloseFile(i + 1);
+				}
 			}
 
-#ifdef ZIP
-			if (fs_searchPaths->pack->pk3)
+			fclose(fs_searchPaths->pack->handle);
+
+#ifndef _WIN32
+			/* Mappings outlive the pack, but must not be shared anymore. */
+			for (map = fs_mappings; map; map = map->next)
 			{
-				unzClose(fs_searchPaths->pack->pk3);
+				if (map->file && (map->file->pack == fs_searchPaths->pack))
+				{
+					map->file = NULL;
+				}
 			}
 #endif
 
@@ -1202,11 +1678,7 @@ FS_SetGamedir(char *dir)
 	for (i = 0; i < MAX_HANDLES; i++)
 	{
 		if (strstr(fs_handles[i].name, dir) &&
-			((fs_handles[i].file != NULL)
-#ifdef ZIP
-			  || (fs_handles[i].zip != NULL)
-#endif
-			))
+			((fs_handles[i].file != NULL) || (fs_handles[i].pack != NULL)))
 		{
 			FS_FCloseFile(i);
 		}
@@ -86,6 +86,7 @@ typedef struct sizebuf_s
 {
 	qboolean allowoverflow;     /* if false, do a Com_Error */
 	qboolean overflowed;        /* set to true if the buffer size failed */
+	qboolean quietoverflow;     /* the owner reports overflows itself */
 	byte *data;
 	int maxsize;
 	int cursize;
@@ -479,6 +480,19 @@ void Cvar_GetLatchedVars(void);
 
 /* any CVAR_LATCHED variables that have been set will now take effect */
 
+typedef void (*cvarcallback_t)(cvar_t *var);
+
+void Cvar_Subscribe(cvar_t *var, cvarcallback_t callback);
+void Cvar_Unsubscribe(cvar_t *var, cvarcallback_t callback);
+
+/* the callback is run by Cvar_RunCallbacks once the value changed, */
+/* latched values when they take effect. It's run once right after */
+/* subscribing too, like ->modified starts out set. */
+
+void Cvar_RunCallbacks(void);
+
+/* called once a frame, after the console commands were executed */
+
 qboolean Cvar_Command(void);
 
 /* called by Cmd_ExecuteString when Cmd_Argv(0) doesn't match a known */
@@ -541,6 +555,8 @@ void NET_Config(qboolean multiplayer);
 qboolean NET_GetPacket(netsrc_t sock, netadr_t *net_from,
 		sizebuf_t *net_message);
 void NET_SendPacket(netsrc_t sock, int length, void *data, netadr_t to);
+void NET_QueuePackets(netsrc_t sock);
+void NET_FlushPackets(netsrc_t sock);
 
 qboolean NET_CompareAdr(netadr_t a, netadr_t b);
 qboolean NET_CompareBaseAdr(netadr_t a, netadr_t b);
@@ -628,8 +644,24 @@ trace_t CM_TransformedBoxTrace(vec3_t start, vec3_t end,
 		vec3_t mins, vec3_t maxs, int headnode,
 		int brushmask, vec3_t origin, vec3_t angles);
 
+/* reentrant versions of the above, every thread
+   tracing at the same time needs its own context */
+typedef struct cmtrace_s cmtrace_t;
+
+cmtrace_t *CM_NewTraceContext(void);
+void CM_FreeTraceContext(cmtrace_t *ctx);
+int CM_HeadnodeForBoxContext(cmtrace_t *ctx, vec3_t mins, vec3_t maxs);
+int CM_TransformedPointContentsContext(cmtrace_t *ctx, vec3_t p,
+		int headnode, vec3_t origin, vec3_t angles);
+trace_t CM_BoxTraceContext(cmtrace_t *ctx, vec3_t start, vec3_t end,
+		vec3_t mins, vec3_t maxs, int headnode, int brushmask);
+trace_t CM_TransformedBoxTraceContext(cmtrace_t *ctx, vec3_t start,
+		vec3_t end, vec3_t mins, vec3_t maxs, int headnode,
+		int brushmask, vec3_t origin, vec3_t angles);
+
 byte *CM_ClusterPVS(int cluster);
 byte *CM_ClusterPHS(int cluster);
+void CM_VisCacheStats(void);
 
 int CM_PointLeafnum(vec3_t p);
 
@@ -650,6 +682,13 @@ qboolean CM_HeadnodeVisible(int headnode, byte *visbits);
 
 void CM_WritePortalState(FILE *f);
 
+/* collision benchmark, cmbench.c */
+extern qboolean cmb_recording;
+
+void CMB_RecordTrace(vec3_t start, vec3_t end, vec3_t mins, vec3_t maxs,
+		int headnode, int brushmask);
+void CMB_Bench_f(void);
+
 /* PLAYER MOVEMENT CODE */
 
 extern float pm_airaccelerate;
@@ -703,6 +742,10 @@ char *FS_NextPath(char *prevpath);
 void FS_ExecAutoexec(void);
 int FS_LoadFile(char *path, void **buffer);
 
+/* like FS_LoadFile, but the buffer may be a read-only */
+/* view into a mapped pack, release it with FS_FreeFile */
+int FS_MapFile(char *path, void **buffer);
+
 /* a null buffer will just return the file length without loading */
 /* a -1 length is not present */
 
@@ -759,6 +802,7 @@ void Z_FreeTags(int tag);
 
 void Qcommon_Init(int argc, char **argv);
 void Qcommon_Frame(int msec);
+int Qcommon_FrameDelay(void);
 void Qcommon_Shutdown(void);
 
 #define NUMVERTEXNORMALS 162
@@ -781,6 +825,19 @@ void Sys_Quit(void);
 char *Sys_GetHomeDir(void);
 const char *Sys_GetBinaryDir(void);
 
+/* a monotonic clock for profiling, the base is arbitrary */
+long long Sys_Nanoseconds(void);
+
+/* runs job(index, worker) for every index below count on up
+   to threads threads, worker is unique per thread and below
+   threads. Only returns once all jobs are done. The job lock
+   serializes calls into code that isn't reentrant. */
+#define MAX_JOB_THREADS 16
+
+void Sys_RunJobs(int count, int threads, void (*job)(int index, int worker));
+void Sys_JobLock(void);
+void Sys_JobUnlock(void);
+
 void Sys_FreeLibrary(void *handle);
 void *Sys_LoadLibrary(const char *path, const char *sym, void **handle);
 void *Sys_GetProcAddress(void *handle, const char *sym);
@@ -791,11 +848,14 @@ void CL_Init(void);
 void CL_Drop(void);
 void CL_Shutdown(void);
 void CL_Frame(int msec);
+int CL_FrameDelay(void);
+qboolean CL_Connected(void);
 void Con_Print(char *text);
 void SCR_BeginLoadingPlaque(void);
 
 void SV_Init(void);
 void SV_Shutdown(char *finalmsg, qboolean reconnect);
 void SV_Frame(int msec);
+int SV_FrameDelay(void);
 
 #endif
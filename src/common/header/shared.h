@@ -232,6 +232,7 @@ void Com_PageInMemory(byte *buffer, int size);
 
 /* portable case insensitive compare */
 int Q_stricmp(const char *s1, const char *s2);
+unsigned Q_strhash(const char *s);
 int Q_strcasecmp(char *s1, char *s2);
 int Q_strncasecmp(char *s1, char *s2, int n);
 
@@ -27,9 +27,10 @@
 #ifndef CO_ZONE_H
 #define CO_ZONE_H
 
+/* the game module peeks at size, keep the layout */
 typedef struct zhead_s
 {
-	struct zhead_s	*prev, *next;
+	struct zhead_s	*prev, *next; /* NULL prev for pooled blocks */
 	short	magic;
 	short	tag; /* for group free */
 	int		size;
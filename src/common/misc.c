@@ -42,7 +42,6 @@ cvar_t *dedicated;
 
 extern cvar_t *logfile_active;
 extern jmp_buf abortframe; /* an ERR_DROP occured, exit the entire frame */
-extern zhead_t z_chain;
 
 static byte chktbl[1024] = {
 	0x84, 0x47, 0x51, 0xc1, 0x93, 0x22, 0x21, 0x24, 0x2f, 0x66, 0x60, 0x4d, 0xb0, 0x7c, 0xda,
@@ -178,6 +177,26 @@ Com_Error_f(void)
 	Com_Error(ERR_FATAL, "%s", Cmd_Argv(1));
 }
 
+static void
+Qcommon_LogStatsChanged(cvar_t *var)
+{
+	if (log_stats_file)
+	{
+		fclose(log_stats_file);
+		log_stats_file = 0;
+	}
+
+	if (var->value)
+	{
+		log_stats_file = fopen("stats.log", "w");
+
+		if (log_stats_file)
+		{
+			fprintf(log_stats_file, "entities,dlights,parts,frame time\n");
+		}
+	}
+}
+
 void
 Qcommon_Init(int argc, char **argv)
 {
@@ -186,8 +205,6 @@ Qcommon_Init(int argc, char **argv)
 		Sys_Error("Error during initialization");
 	}
 
-	z_chain.next = z_chain.prev = &z_chain;
-
 	/* prepare enough of the subsystems to handle
 	   cvar and command buffer management */
 	COM_InitArgv(argc, argv);
@@ -224,6 +241,7 @@ Qcommon_Init(int argc, char **argv)
 
 	host_speeds = Cvar_Get("host_speeds", "0", 0);
 	log_stats = Cvar_Get("log_stats", "0", 0);
+	Cvar_Subscribe(log_stats, Qcommon_LogStatsChanged);
 	developer = Cvar_Get("developer", "0", 0);
 	modder = Cvar_Get("modder", "0", 0);
 	timescale = Cvar_Get("timescale", "1", 0);
@@ -298,35 +316,6 @@ Qcommon_Frame(int msec)
 		return; /* an ERR_DROP was thrown */
 	}
 
-	if (log_stats->modified)
-	{
-		log_stats->modified = false;
-
-		if (log_stats->value)
-		{
-			if (log_stats_file)
-			{
-				fclose(log_stats_file);
-				log_stats_file = 0;
-			}
-
-			log_stats_file = fopen("stats.log", "w");
-
-			if (log_stats_file)
-			{
-				fprintf(log_stats_file, "entities,dlights,parts,frame time\n");
-			}
-		}
-		else
-		{
-			if (log_stats_file)
-			{
-				fclose(log_stats_file);
-				log_stats_file = 0;
-			}
-		}
-	}
-
 	if (fixedtime->value)
 	{
 		msec = fixedtime->value;
@@ -367,6 +356,7 @@ Qcommon_Frame(int msec)
 	while (s);
 
 	Cbuf_Execute();
+	Cvar_RunCallbacks();
 
 #ifndef DEDICATED_ONLY
 	if (host_speeds->value)
@@ -403,6 +393,53 @@ Qcommon_Frame(int msec)
 #endif
 }
 
+/*
+ * Returns the number of milliseconds the main loop
+ * may sleep until Qcommon_Frame() must be called
+ * again. Network packets and console input may
+ * wake it up earlier.
+ */
+int
+Qcommon_FrameDelay(void)
+{
+	int delay;
+#ifndef DEDICATED_ONLY
+	int cldelay;
+#endif
+
+	/* every frame advances the game by
+	   the same time, run them at once */
+	if (fixedtime->value)
+	{
+		return 0;
+	}
+
+	delay = SV_FrameDelay();
+
+#ifndef DEDICATED_ONLY
+	cldelay = CL_FrameDelay();
+
+	if ((cldelay >= 0) && ((delay < 0) || (cldelay < delay)))
+	{
+		delay = cldelay;
+	}
+#endif
+
+	/* nothing scheduled, check
+	   again after a server frame */
+	if ((delay < 0) || (delay > 100))
+	{
+		delay = 100;
+	}
+
+	if (timescale->value > 0)
+	{
+		delay /= timescale->value;
+	}
+
+	return delay;
+}
+
 void
 Qcommon_Shutdown(void)
 {
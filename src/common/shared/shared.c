@@ -1034,6 +1034,25 @@ Q_stricmp(const char *s1, const char *s2)
 	return strcasecmp(s1, s2);
 }
 
+/*
+ * FNV-1a hash of the lower case string, so strings
+ * that Q_stricmp() finds equal hash the same.
+ */
+unsigned
+Q_strhash(const char *s)
+{
+	unsigned hash;
+
+	hash = 2166136261u;
+
+	while (*s)
+	{
+		hash = (hash ^ tolower((unsigned char)*s++)) * 16777619u;
+	}
+
+	return hash;
+}
+
 int
 Q_strncasecmp(char *s1, char *s2, int n)
 {
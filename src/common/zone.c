@@ -19,7 +19,10 @@
  *
  * =======================================================================
  *
- * Zone malloc. It's just a normal malloc with tags.
+ * Zone malloc. Every tag has its own arena: small blocks are carved
+ * out of big chunks in a few size classes and recycled through free
+ * lists, bigger ones come from malloc. Freeing a tag releases the
+ * chunks, without looking at the blocks in them.
  *
  * =======================================================================
  */
@@ -28,14 +31,111 @@
 #include "header/zone.h"
 
 #define Z_MAGIC 0x1d1d
+#define Z_FREEMAGIC 0x1d1e /* pooled block on a free list */
 
-zhead_t z_chain;
+#define Z_CHUNKSIZE 0x10000
+#define Z_CHUNKHEADER 16 /* keeps blocks aligned like malloc does */
+#define Z_NUMCLASSES 6 /* 32 to 1024 bytes, header included */
+#define Z_MAXARENAS 32
+
+typedef struct zchunk_s
+{
+	struct zchunk_s *next;
+} zchunk_t;
+
+typedef struct
+{
+	qboolean used;
+	short tag;
+	zchunk_t *chunks;
+	byte *bump, *bumpend; /* unused part of the newest chunk */
+	zhead_t *free[Z_NUMCLASSES];
+	zhead_t large; /* blocks too big for a size class */
+	int count, bytes;
+	int numchunks;
+} zarena_t;
+
+static zarena_t z_arenas[Z_MAXARENAS];
+static zarena_t *z_lastarena;
 int z_count, z_bytes;
 
+static zarena_t *
+Z_FindArena(short tag, qboolean create)
+{
+	zarena_t *arena, *unused;
+	int i;
+
+	if (z_lastarena && (z_lastarena->tag == tag))
+	{
+		return z_lastarena;
+	}
+
+	unused = NULL;
+
+	for (i = 0, arena = z_arenas; i < Z_MAXARENAS; i++, arena++)
+	{
+		if (!arena->used)
+		{
+			if (!unused)
+			{
+				unused = arena;
+			}
+
+			continue;
+		}
+
+		if (arena->tag == tag)
+		{
+			z_lastarena = arena;
+			return arena;
+		}
+	}
+
+	if (!create)
+	{
+		return NULL;
+	}
+
+	if (!unused)
+	{
+		Com_Error(ERR_FATAL, "Z_TagMalloc: too many tags");
+	}
+
+	memset(unused, 0, sizeof(*unused));
+	unused->used = true;
+	unused->tag = tag;
+	unused->large.next = unused->large.prev = &unused->large;
+
+	z_lastarena = unused;
+	return unused;
+}
+
+/*
+ * Returns the size class for size bytes
+ * including the header, -1 if too big.
+ */
+static int
+Z_SizeClass(int size)
+{
+	int c;
+
+	for (c = 0; c < Z_NUMCLASSES; c++)
+	{
+		if (size <= (32 << c))
+		{
+			return c;
+		}
+	}
+
+	return -1;
+}
+
 void
 Z_Free(void *ptr)
 {
 	zhead_t *z;
+	zarena_t *arena;
+	int c;
 
 	z = ((zhead_t *)ptr) - 1;
 
@@ -46,61 +146,164 @@ Z_Free(void *ptr)
 		Com_Error(ERR_FATAL, "Z_Free: bad magic");
 	}
 
-	z->prev->next = z->next;
-	z->next->prev = z->prev;
+	arena = Z_FindArena(z->tag, false);
+
+	if (!arena)
+	{
+		Com_Error(ERR_FATAL, "Z_Free: no arena for tag %i", z->tag);
+	}
 
+	arena->count--;
+	arena->bytes -= z->size;
 	z_count--;
 	z_bytes -= z->size;
-	free(z);
+
+	if (z->prev)
+	{
+		z->prev->next = z->next;
+		z->next->prev = z->prev;
+		free(z);
+		return;
+	}
+
+	/* back to the pool, the chunk is released by Z_FreeTags() */
+	c = Z_SizeClass(z->size);
+	z->magic = Z_FREEMAGIC;
+	z->next = arena->free[c];
+	arena->free[c] = z;
 }
 
 void
 Z_Stats_f(void)
 {
+	zarena_t *arena;
+	int i;
+
 	Com_Printf("%i bytes in %i blocks\n", z_bytes, z_count);
+
+	for (i = 0, arena = z_arenas; i < Z_MAXARENAS; i++, arena++)
+	{
+		if (arena->used)
+		{
+			Com_Printf("tag %5i: %i bytes in %i blocks, %i chunks\n",
+					arena->tag, arena->bytes, arena->count, arena->numchunks);
+		}
+	}
 }
 
 void
 Z_FreeTags(int tag)
 {
+	zarena_t *arena;
 	zhead_t *z, *next;
+	zchunk_t *chunk, *nextchunk;
 
-	for (z = z_chain.next; z != &z_chain; z = next)
+	arena = Z_FindArena(tag, false);
+
+	if (!arena)
+	{
+		return;
+	}
+
+	for (z = arena->large.next; z != &arena->large; z = next)
 	{
 		next = z->next;
+		free(z);
+	}
 
-		if (z->tag == tag)
-		{
-			Z_Free((void *)(z + 1));
-		}
+	for (chunk = arena->chunks; chunk; chunk = nextchunk)
+	{
+		nextchunk = chunk->next;
+		free(chunk);
+	}
+
+	z_count -= arena->count;
+	z_bytes -= arena->bytes;
+
+	if (z_lastarena == arena)
+	{
+		z_lastarena = NULL;
 	}
+
+	memset(arena, 0, sizeof(*arena));
 }
 
 void *
 Z_TagMalloc(int size, int tag)
 {
 	zhead_t *z;
+	zarena_t *arena;
+	zchunk_t *chunk;
+	int c;
 
-	size = size + sizeof(zhead_t);
-	z = malloc(size);
+	arena = Z_FindArena(tag, true);
+	c = Z_SizeClass(size + sizeof(zhead_t));
 
-	if (!z)
+	if (c < 0)
 	{
-		Com_Error(ERR_FATAL, "Z_Malloc: failed on allocation of %i bytes", size);
+		size = size + sizeof(zhead_t);
+		z = malloc(size);
+
+		if (!z)
+		{
+			Com_Error(ERR_FATAL, "Z_Malloc: failed on allocation of %i bytes", size);
+		}
+
+		memset(z, 0, size);
+
+		z->next = arena->large.next;
+		z->prev = &arena->large;
+		arena->large.next->prev = z;
+		arena->large.next = z;
 	}
+	else
+	{
+		size = 32 << c;
+
+		if (arena->free[c])
+		{
+			z = arena->free[c];
+			arena->free[c] = z->next;
 
-	memset(z, 0, size);
+			if (z->magic != Z_FREEMAGIC)
+			{
+				Com_Error(ERR_FATAL, "Z_Malloc: free list of tag %i is corrupt", tag);
+			}
+		}
+		else
+		{
+			if (arena->bump + size > arena->bumpend)
+			{
+				chunk = malloc(Z_CHUNKSIZE);
+
+				if (!chunk)
+				{
+					Com_Error(ERR_FATAL, "Z_Malloc: failed on allocation of %i bytes",
+							Z_CHUNKSIZE);
+				}
+
+				chunk->next = arena->chunks;
+				arena->chunks = chunk;
+				arena->numchunks++;
+				arena->bump = (byte *)chunk + Z_CHUNKHEADER;
+				arena->bumpend = (byte *)chunk + Z_CHUNKSIZE;
+			}
+
+			z = (zhead_t *)arena->bump;
+			arena->bump += size;
+		}
+
+		memset(z, 0, size);
+	}
+
+	arena->count++;
+	arena->bytes += size;
 	z_count++;
 	z_bytes += size;
 	z->magic = Z_MAGIC;
 	z->tag = tag;
 	z->size = size;
 
-	z->next = z_chain.next;
-	z->prev = &z_chain;
-	z_chain.next->prev = z;
-	z_chain.next = z;
-
 	return (void *)(z + 1);
 }
 
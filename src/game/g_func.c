@@ -111,7 +111,7 @@ Move_Final(edict_t *ent)
 			ent->velocity);
 
 	ent->think = Move_Done;
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink(ent, level.time + FRAMETIME);
 }
 
 void
@@ -136,7 +136,7 @@ Move_Begin(edict_t *ent)
 			 ent->moveinfo.speed) / FRAMETIME);
 	ent->moveinfo.remaining_distance -= frames * ent->moveinfo.speed *
 										FRAMETIME;
-	ent->nextthink = level.time + (frames * FRAMETIME);
+	G_SetNextThink(ent, level.time + (frames * FRAMETIME));
 	ent->think = Move_Final;
 }
 
@@ -163,7 +163,7 @@ Move_Calc(edict_t *ent, vec3_t dest, void (*func)(edict_t *))
 		}
 		else
 		{
-			ent->nextthink = level.time + FRAMETIME;
+			G_SetNextThink(ent, level.time + FRAMETIME);
 			ent->think = Move_Begin;
 		}
 	}
@@ -172,7 +172,7 @@ Move_Calc(edict_t *ent, vec3_t dest, void (*func)(edict_t *))
 		/* accelerative */
 		ent->moveinfo.current_speed = 0;
 		ent->think = Think_AccelMove;
-		ent->nextthink = level.time + FRAMETIME;
+		G_SetNextThink(ent, level.time + FRAMETIME);
 	}
 }
 
@@ -218,7 +218,7 @@ AngleMove_Final(edict_t *ent)
 	VectorScale(move, 1.0 / FRAMETIME, ent->avelocity);
 
 	ent->think = AngleMove_Done;
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink(ent, level.time + FRAMETIME);
 }
 
 void
@@ -262,7 +262,7 @@ AngleMove_Begin(edict_t *ent)
 	VectorScale(destdelta, 1.0 / traveltime, ent->avelocity);
 
 	/* set nextthink to trigger a think when dest is reached */
-	ent->nextthink = level.time + frames * FRAMETIME;
+	G_SetNextThink(ent, level.time + frames * FRAMETIME);
 	ent->think = AngleMove_Final;
 }
 
@@ -284,7 +284,7 @@ AngleMove_Calc(edict_t *ent, void (*func)(edict_t *))
 	}
 	else
 	{
-		ent->nextthink = level.time + FRAMETIME;
+		G_SetNextThink(ent, level.time + FRAMETIME);
 		ent->think = AngleMove_Begin;
 	}
 }
@@ -456,7 +456,7 @@ Think_AccelMove(edict_t *ent)
 
 	VectorScale(ent->moveinfo.dir, ent->moveinfo.current_speed * 10,
 			ent->velocity);
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink(ent, level.time + FRAMETIME);
 	ent->think = Think_AccelMove;
 }
 
@@ -482,7 +482,7 @@ plat_hit_top(edict_t *ent)
 	ent->moveinfo.state = STATE_TOP;
 
 	ent->think = plat_go_down;
-	ent->nextthink = level.time + 3;
+	G_SetNextThink(ent, level.time + 3);
 }
 
 void
@@ -635,7 +635,7 @@ Touch_Plat_Center(edict_t *ent, edict_t *other, cplane_t *plane /* unused */,
 	else if (ent->moveinfo.state == STATE_TOP)
 	{
 		/* the player is still on the plat, so delay going down */
-		ent->nextthink = level.time + 1;
+		G_SetNextThink(ent, level.time + 1);
 	}
 }
 
@@ -1031,7 +1031,7 @@ button_wait(edict_t *self)
 
 	if (self->moveinfo.wait >= 0)
 	{
-		self->nextthink = level.time + self->moveinfo.wait;
+		G_SetNextThink(self, level.time + self->moveinfo.wait);
 		self->think = button_return;
 	}
 }
@@ -1281,7 +1281,7 @@ door_hit_top(edict_t *self)
 	if (self->moveinfo.wait >= 0)
 	{
 		self->think = door_go_down;
-		self->nextthink = level.time + self->moveinfo.wait;
+		G_SetNextThink(self, level.time + self->moveinfo.wait);
 	}
 }
 
@@ -1365,7 +1365,7 @@ door_go_up(edict_t *self, edict_t *activator)
 		/* reset top wait time */
 		if (self->moveinfo.wait >= 0)
 		{
-			self->nextthink = level.time + self->moveinfo.wait;
+			G_SetNextThink(self, level.time + self->moveinfo.wait);
 		}
 
 		return;
@@ -1804,7 +1804,7 @@ SP_func_door(edict_t *ent)
 
 	gi.linkentity(ent);
 
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink(ent, level.time + FRAMETIME);
 
 	if (ent->health || ent->targetname)
 	{
@@ -1975,7 +1975,7 @@ SP_func_door_rotating(edict_t *ent)
 
 	gi.linkentity(ent);
 
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink(ent, level.time + FRAMETIME);
 
 	if (ent->health || ent->targetname)
 	{
@@ -2085,7 +2085,7 @@ SP_func_water(edict_t *self)
 		self->spawnflags |= DOOR_TOGGLE;
 	}
 
-	self->classname = "func_door";
+	G_SetClassname(self, "func_door");
 
 	gi.linkentity(self);
 }
@@ -2182,7 +2182,7 @@ train_wait(edict_t *self)
 	{
 		if (self->moveinfo.wait > 0)
 		{
-			self->nextthink = level.time + self->moveinfo.wait;
+			G_SetNextThink(self, level.time + self->moveinfo.wait);
 			self->think = train_next;
 		}
 		else if (self->spawnflags & TRAIN_TOGGLE)
@@ -2341,7 +2341,7 @@ func_train_find(edict_t *self)
 
 	if (self->spawnflags & TRAIN_START_ON)
 	{
-		self->nextthink = level.time + FRAMETIME;
+		G_SetNextThink(self, level.time + FRAMETIME);
 		self->think = train_next;
 		self->activator = self;
 	}
@@ -2430,7 +2430,7 @@ SP_func_train(edict_t *self)
 	{
 		/* start trains on the second frame, to make sure
 		   their targets have had a chance to spawn */
-		self->nextthink = level.time + FRAMETIME;
+		G_SetNextThink(self, level.time + FRAMETIME);
 		self->think = func_train_find;
 	}
 	else
@@ -2518,7 +2518,7 @@ SP_trigger_elevator(edict_t *self)
 	}
 
 	self->think = trigger_elevator_init;
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink(self, level.time + FRAMETIME);
 }
 
 /* ==================================================================== */
@@ -2547,7 +2547,7 @@ func_timer_think(edict_t *self)
 	}
 
 	G_UseTargets(self, self->activator);
-	self->nextthink = level.time + self->wait + crandom() * self->random;
+	G_SetNextThink(self, level.time + self->wait + crandom() * self->random);
 }
 
 void
@@ -2570,7 +2570,7 @@ func_timer_use(edict_t *self, edict_t *other /* unused */, edict_t *activator)
 	/* turn it on */
 	if (self->delay)
 	{
-		self->nextthink = level.time + self->delay;
+		G_SetNextThink(self, level.time + self->delay);
 	}
 	else
 	{
@@ -2602,8 +2602,8 @@ SP_func_timer(edict_t *self)
 
 	if (self->spawnflags & 1)
 	{
-		self->nextthink = level.time + 1.0 + st.pausetime + self->delay +
-						  self->wait + crandom() * self->random;
+		G_SetNextThink(self, level.time + 1.0 + st.pausetime + self->delay +
+				self->wait + crandom() * self->random);
 		self->activator = self;
 	}
 
@@ -2726,7 +2726,7 @@ door_secret_move1(edict_t *self)
 		return;
 	}
 
-	self->nextthink = level.time + 1.0;
+	G_SetNextThink(self, level.time + 1.0);
 	self->think = door_secret_move2;
 }
 
@@ -2754,7 +2754,7 @@ door_secret_move3(edict_t *self)
 		return;
 	}
 
-	self->nextthink = level.time + self->wait;
+	G_SetNextThink(self, level.time + self->wait);
 	self->think = door_secret_move4;
 }
 
@@ -2777,7 +2777,7 @@ door_secret_move5(edict_t *self)
 		return;
 	}
 
-	self->nextthink = level.time + 1.0;
+	G_SetNextThink(self, level.time + 1.0);
 	self->think = door_secret_move6;
 }
 
@@ -2941,7 +2941,7 @@ SP_func_door_secret(edict_t *ent)
 		ent->touch = door_touch;
 	}
 
-	ent->classname = "func_door";
+	G_SetClassname(ent, "func_door");
 
 	gi.linkentity(ent);
 }
@@ -2970,7 +2970,7 @@ use_killbox(edict_t *self, edict_t *other /* unused */, edict_t *activator /* un
 	if (!self->count)
 	{
 		self->think = G_FreeEdict;
-		self->nextthink = level.time + 1;
+		G_SetNextThink(self, level.time + 1);
 	}
 }
 
@@ -58,6 +58,13 @@ static int power_shield_index;
 void Use_Quad(edict_t *ent, gitem_t *item);
 static int quad_drop_timeout_hack;
 
+/* used by FindItem() and FindItemByClassname(),
+   built by InitItems() */
+static tableindex_t item_classindex;
+static int item_classnext[MAX_ITEMS];
+static tableindex_t item_pickupindex;
+static int item_pickupnext[MAX_ITEMS];
+
 /* ====================================================================== */
 
 gitem_t *
@@ -82,14 +89,10 @@ FindItemByClassname(char *classname)
 		return NULL;
 	}
 
-	it = itemlist;
-
-	for (i = 0; i < game.num_items; i++, it++)
+	for (i = G_TableIndexFirst(&item_classindex, Q_strhash(classname));
+		 i >= 0; i = item_classnext[i])
 	{
-		if (!it->classname)
-		{
-			continue;
-		}
+		it = &itemlist[i];
 
 		if (!Q_stricmp(it->classname, classname))
 		{
@@ -111,14 +114,10 @@ FindItem(char *pickup_name)
 		return NULL;
 	}
 
-	it = itemlist;
-
-	for (i = 0; i < game.num_items; i++, it++)
+	for (i = G_TableIndexFirst(&item_pickupindex, Q_strhash(pickup_name));
+		 i >= 0; i = item_pickupnext[i])
 	{
-		if (!it->pickup_name)
-		{
-			continue;
-		}
+		it = &itemlist[i];
 
 		if (!Q_stricmp(it->pickup_name, pickup_name))
 		{
@@ -177,7 +176,7 @@ SetRespawn(edict_t *ent, float delay)
 	ent->flags |= FL_RESPAWN;
 	ent->svflags |= SVF_NOCLIENT;
 	ent->solid = SOLID_NOT;
-	ent->nextthink = level.time + delay;
+	G_SetNextThink(ent, level.time + delay);
 	ent->think = DoRespawn;
 	gi.linkentity(ent);
 }
@@ -826,7 +825,7 @@ MegaHealth_think(edict_t *self)
 
 	if (self->owner->health > self->owner->max_health)
 	{
-		self->nextthink = level.time + 1;
+		G_SetNextThink(self, level.time + 1);
 		self->owner->health -= 1;
 		return;
 	}
@@ -870,7 +869,7 @@ Pickup_Health(edict_t *ent, edict_t *other)
 	if (ent->style & HEALTH_TIMED)
 	{
 		ent->think = MegaHealth_think;
-		ent->nextthink = level.time + 5;
+		G_SetNextThink(ent, level.time + 5);
 		ent->owner = other;
 		ent->flags |= FL_RESPAWN;
 		ent->svflags |= SVF_NOCLIENT;
@@ -1276,7 +1275,7 @@ drop_make_touchable(edict_t *ent)
 
 	if (deathmatch->value)
 	{
-		ent->nextthink = level.time + 29;
+		G_SetNextThink(ent, level.time + 29);
 		ent->think = G_FreeEdict;
 	}
 }
@@ -1295,7 +1294,7 @@ Drop_Item(edict_t *ent, gitem_t *item)
 
 	dropped = G_Spawn();
 
-	dropped->classname = item->classname;
+	G_SetClassname(dropped, item->classname);
 	dropped->item = item;
 	dropped->spawnflags = DROPPED_ITEM;
 	dropped->s.effects = item->world_model_flags;
@@ -1340,7 +1339,7 @@ Drop_Item(edict_t *ent, gitem_t *item)
 	dropped->velocity[2] = 300;
 
 	dropped->think = drop_make_touchable;
-	dropped->nextthink = level.time + 1;
+	G_SetNextThink(dropped, level.time + 1);
 
 	gi.linkentity(dropped);
 
@@ -1430,7 +1429,7 @@ droptofloor(edict_t *ent)
 
 		if (ent == ent->teammaster)
 		{
-			ent->nextthink = level.time + FRAMETIME;
+			G_SetNextThink(ent, level.time + FRAMETIME);
 			ent->think = DoRespawn;
 		}
 	}
@@ -1642,7 +1641,7 @@ SpawnItem(edict_t *ent, gitem_t *item)
 	}
 
 	ent->item = item;
-	ent->nextthink = level.time + 2 * FRAMETIME; /* items start after other solids */
+	G_SetNextThink(ent, level.time + 2 * FRAMETIME); /* items start after other solids */
 	ent->think = droptofloor;
 	ent->s.effects = item->world_model_flags;
 	ent->s.renderfx = RF_GLOW;
@@ -2673,7 +2672,34 @@ SP_item_health_mega(edict_t *self)
 void
 InitItems(void)
 {
+	int i;
+	gitem_t *it;
+
 	game.num_items = sizeof(itemlist) / sizeof(itemlist[0]) - 1;
+
+	if (game.num_items > MAX_ITEMS)
+	{
+		gi.error("InitItems: %i items, MAX_ITEMS is %i",
+				game.num_items, MAX_ITEMS);
+	}
+
+	G_ClearTableIndex(&item_classindex, item_classnext);
+	G_ClearTableIndex(&item_pickupindex, item_pickupnext);
+
+	for (i = 0; i < game.num_items; i++)
+	{
+		it = &itemlist[i];
+
+		if (it->classname)
+		{
+			G_AddTableIndex(&item_classindex, i, Q_strhash(it->classname));
+		}
+
+		if (it->pickup_name)
+		{
+			G_AddTableIndex(&item_pickupindex, i, Q_strhash(it->pickup_name));
+		}
+	}
 }
 
 /*
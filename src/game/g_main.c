@@ -77,6 +77,7 @@ cvar_t *flood_persecond;
 cvar_t *flood_waitdelay;
 
 cvar_t *sv_maplist;
+cvar_t *g_linear_findradius;
 
 cvar_t *gib_on;
 
@@ -212,7 +213,7 @@ CreateTargetChangeLevel(char *map)
 	}
 
 	ent = G_Spawn();
-	ent->classname = "target_changelevel";
+	G_SetClassname(ent, "target_changelevel");
 	Com_sprintf(level.nextmap, sizeof(level.nextmap), "%s", map);
 	ent->map = level.nextmap;
 	return ent;
@@ -420,6 +421,8 @@ G_RunFrame(void)
 	level.framenum++;
 	level.time = level.framenum * FRAMETIME;
 
+	G_AdvanceThinks();
+
 	/* choose a client for monsters to target this frame */
 	AI_SetSightClient();
 
@@ -465,6 +468,14 @@ G_RunFrame(void)
 			continue;
 		}
 
+		/* without physics there's nothing to
+		   do until the scheduler says so */
+		if ((ent->movetype == MOVETYPE_NONE) && !ent->prethink &&
+			!G_ThinkDue(ent))
+		{
+			continue;
+		}
+
 		G_RunEntity(ent);
 	}
 
@@ -126,12 +126,12 @@ gib_think(edict_t *self)
 	}
 
 	self->s.frame++;
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink(self, level.time + FRAMETIME);
 
 	if (self->s.frame == 10)
 	{
 		self->think = G_FreeEdict;
-		self->nextthink = level.time + 8 + random() * 10;
+		G_SetNextThink(self, level.time + 8 + random() * 10);
 	}
 }
 
@@ -165,7 +165,7 @@ gib_touch(edict_t *self, edict_t *other /* unused */, cplane_t *plane, csurface_
 		{
 			self->s.frame++;
 			self->think = gib_think;
-			self->nextthink = level.time + FRAMETIME;
+			G_SetNextThink(self, level.time + FRAMETIME);
 		}
 	}
 }
@@ -244,7 +244,7 @@ ThrowGib(edict_t *self, char *gibname, int damage, int type)
 	gib->avelocity[2] = random() * 600;
 
 	gib->think = G_FreeEdict;
-	gib->nextthink = level.time + 10 + random() * 10;
+	G_SetNextThink(gib, level.time + 10 + random() * 10);
 
 	gi.linkentity(gib);
 }
@@ -274,7 +274,7 @@ ThrowHead(edict_t *self, char *gibname, int damage, int type)
 	self->flags |= FL_NO_KNOCKBACK;
 	self->svflags &= ~SVF_MONSTER;
 	self->takedamage = DAMAGE_YES;
-	self->targetname = NULL;
+	G_SetTargetname(self, NULL);
 	self->die = gib_die;
 
 	if (type == GIB_ORGANIC)
@@ -296,7 +296,7 @@ ThrowHead(edict_t *self, char *gibname, int damage, int type)
 	self->avelocity[YAW] = crandom() * 600;
 
 	self->think = G_FreeEdict;
-	self->nextthink = level.time + 10 + random() * 10;
+	G_SetNextThink(self, level.time + 10 + random() * 10);
 
 	gi.linkentity(self);
 }
@@ -404,10 +404,10 @@ ThrowDebris(edict_t *self, char *modelname, float speed, vec3_t origin)
 	chunk->avelocity[1] = random() * 600;
 	chunk->avelocity[2] = random() * 600;
 	chunk->think = G_FreeEdict;
-	chunk->nextthink = level.time + 5 + random() * 5;
+	G_SetNextThink(chunk, level.time + 5 + random() * 5);
 	chunk->s.frame = 0;
 	chunk->flags = 0;
-	chunk->classname = "debris";
+	G_SetClassname(chunk, "debris");
 	chunk->takedamage = DAMAGE_YES;
 	chunk->die = debris_die;
 	gi.linkentity(chunk);
@@ -670,7 +670,7 @@ TH_viewthing(edict_t *ent)
 	}
 
 	ent->s.frame = (ent->s.frame + 1) % 7;
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink(ent, level.time + FRAMETIME);
 }
 
 void
@@ -690,7 +690,7 @@ SP_viewthing(edict_t *ent)
 	VectorSet(ent->maxs, 16, 16, 32);
 	ent->s.modelindex = gi.modelindex("models/objects/banner/tris.md2");
 	gi.linkentity(ent);
-	ent->nextthink = level.time + 0.5;
+	G_SetNextThink(ent, level.time + 0.5);
 	ent->think = TH_viewthing;
 	return;
 }
@@ -981,7 +981,7 @@ SP_func_object(edict_t *self)
 		self->solid = SOLID_BSP;
 		self->movetype = MOVETYPE_PUSH;
 		self->think = func_object_release;
-		self->nextthink = level.time + 2 * FRAMETIME;
+		G_SetNextThink(self, level.time + 2 * FRAMETIME);
 	}
 	else
 	{
@@ -1318,7 +1318,7 @@ barrel_delay(edict_t *self, edict_t *inflictor /* unused */, edict_t *attacker,
 	}
 
 	self->takedamage = DAMAGE_NO;
-	self->nextthink = level.time + 2 * FRAMETIME;
+	G_SetNextThink(self, level.time + 2 * FRAMETIME);
 	self->think = barrel_explode;
 	self->activator = attacker;
 }
@@ -1372,7 +1372,7 @@ SP_misc_explobox(edict_t *self)
 	self->touch = barrel_touch;
 
 	self->think = M_droptofloor;
-	self->nextthink = level.time + 2 * FRAMETIME;
+	G_SetNextThink(self, level.time + 2 * FRAMETIME);
 
 	gi.linkentity(self);
 }
@@ -1404,12 +1404,12 @@ misc_blackhole_think(edict_t *self)
 
 	if (++self->s.frame < 19)
 	{
-		self->nextthink = level.time + FRAMETIME;
+		G_SetNextThink(self, level.time + FRAMETIME);
 	}
 	else
 	{
 		self->s.frame = 0;
-		self->nextthink = level.time + FRAMETIME;
+		G_SetNextThink(self, level.time + FRAMETIME);
 	}
 }
 
@@ -1437,7 +1437,7 @@ SP_misc_blackhole(edict_t *ent)
 	ent->use = misc_blackhole_use;
 	ent->think = misc_blackhole_think;
     ent->prethink = misc_blackhole_transparent;
-	ent->nextthink = level.time + 2 * FRAMETIME;
+	G_SetNextThink(ent, level.time + 2 * FRAMETIME);
 	gi.linkentity(ent);
 }
 
@@ -1456,12 +1456,12 @@ misc_eastertank_think(edict_t *self)
 
 	if (++self->s.frame < 293)
 	{
-		self->nextthink = level.time + FRAMETIME;
+		G_SetNextThink(self, level.time + FRAMETIME);
 	}
 	else
 	{
 		self->s.frame = 254;
-		self->nextthink = level.time + FRAMETIME;
+		G_SetNextThink(self, level.time + FRAMETIME);
 	}
 }
 
@@ -1480,7 +1480,7 @@ SP_misc_eastertank(edict_t *ent)
 	ent->s.modelindex = gi.modelindex("models/monsters/tank/tris.md2");
 	ent->s.frame = 254;
 	ent->think = misc_eastertank_think;
-	ent->nextthink = level.time + 2 * FRAMETIME;
+	G_SetNextThink(ent, level.time + 2 * FRAMETIME);
 	gi.linkentity(ent);
 }
 
@@ -1499,12 +1499,12 @@ misc_easterchick_think(edict_t *self)
 
 	if (++self->s.frame < 247)
 	{
-		self->nextthink = level.time + FRAMETIME;
+		G_SetNextThink(self, level.time + FRAMETIME);
 	}
 	else
 	{
 		self->s.frame = 208;
-		self->nextthink = level.time + FRAMETIME;
+		G_SetNextThink(self, level.time + FRAMETIME);
 	}
 }
 
@@ -1523,7 +1523,7 @@ SP_misc_easterchick(edict_t *ent)
 	ent->s.modelindex = gi.modelindex("models/monsters/bitch/tris.md2");
 	ent->s.frame = 208;
 	ent->think = misc_easterchick_think;
-	ent->nextthink = level.time + 2 * FRAMETIME;
+	G_SetNextThink(ent, level.time + 2 * FRAMETIME);
 	gi.linkentity(ent);
 }
 
@@ -1540,12 +1540,12 @@ misc_easterchick2_think(edict_t *self)
 
 	if (++self->s.frame < 287)
 	{
-		self->nextthink = level.time + FRAMETIME;
+		G_SetNextThink(self, level.time + FRAMETIME);
 	}
 	else
 	{
 		self->s.frame = 248;
-		self->nextthink = level.time + FRAMETIME;
+		G_SetNextThink(self, level.time + FRAMETIME);
 	}
 }
 
@@ -1564,7 +1564,7 @@ SP_misc_easterchick2(edict_t *ent)
 	ent->s.modelindex = gi.modelindex("models/monsters/bitch/tris.md2");
 	ent->s.frame = 248;
 	ent->think = misc_easterchick2_think;
-	ent->nextthink = level.time + 2 * FRAMETIME;
+	G_SetNextThink(ent, level.time + 2 * FRAMETIME);
 	gi.linkentity(ent);
 }
 
@@ -1585,7 +1585,7 @@ commander_body_think(edict_t *self)
 
 	if (++self->s.frame < 24)
 	{
-		self->nextthink = level.time + FRAMETIME;
+		G_SetNextThink(self, level.time + FRAMETIME);
 	}
 	else
 	{
@@ -1608,7 +1608,7 @@ commander_body_use(edict_t *self, edict_t *other /* unused */, edict_t *activato
 	}
 
 	self->think = commander_body_think;
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink(self, level.time + FRAMETIME);
 	gi.sound(self, CHAN_BODY, gi.soundindex("tank/pain.wav"), 1, ATTN_NORM, 0);
 }
 
@@ -1648,7 +1648,7 @@ SP_monster_commander_body(edict_t *self)
 	gi.soundindex("tank/pain.wav");
 
 	self->think = commander_body_drop;
-	self->nextthink = level.time + 5 * FRAMETIME;
+	G_SetNextThink(self, level.time + 5 * FRAMETIME);
 }
 
 /* ===================================================== */
@@ -1667,7 +1667,7 @@ misc_banner_think(edict_t *ent)
 	}
 
 	ent->s.frame = (ent->s.frame + 1) % 16;
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink(ent, level.time + FRAMETIME);
 }
 
 void
@@ -1685,7 +1685,7 @@ SP_misc_banner(edict_t *ent)
 	gi.linkentity(ent);
 
 	ent->think = misc_banner_think;
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink(ent, level.time + FRAMETIME);
 }
 
 /* ===================================================== */
@@ -1833,7 +1833,7 @@ SP_misc_viper(edict_t *ent)
 	VectorSet(ent->maxs, 16, 16, 32);
 
 	ent->think = func_train_find;
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink(ent, level.time + FRAMETIME);
 	ent->use = misc_viper_use;
 	ent->svflags |= SVF_NOCLIENT;
 	ent->moveinfo.accel = ent->moveinfo.decel = ent->moveinfo.speed =
@@ -2016,7 +2016,7 @@ SP_misc_strogg_ship(edict_t *ent)
 	VectorSet(ent->maxs, 16, 16, 32);
 
 	ent->think = func_train_find;
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink(ent, level.time + FRAMETIME);
 	ent->use = misc_strogg_ship_use;
 	ent->svflags |= SVF_NOCLIENT;
 	ent->moveinfo.accel = ent->moveinfo.decel =
@@ -2042,7 +2042,7 @@ misc_satellite_dish_think(edict_t *self)
 
 	if (self->s.frame < 38)
 	{
-		self->nextthink = level.time + FRAMETIME;
+		G_SetNextThink(self, level.time + FRAMETIME);
 	}
 }
 
@@ -2056,7 +2056,7 @@ misc_satellite_dish_use(edict_t *self, edict_t *other /* unused */, edict_t *act
 
 	self->s.frame = 0;
 	self->think = misc_satellite_dish_think;
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink(self, level.time + FRAMETIME);
 }
 
 void
@@ -2138,7 +2138,7 @@ SP_misc_gib_arm(edict_t *ent)
 	ent->avelocity[1] = random() * 200;
 	ent->avelocity[2] = random() * 200;
 	ent->think = G_FreeEdict;
-	ent->nextthink = level.time + 30;
+	G_SetNextThink(ent, level.time + 30);
 	gi.linkentity(ent);
 }
 
@@ -2166,7 +2166,7 @@ SP_misc_gib_leg(edict_t *ent)
 	ent->avelocity[1] = random() * 200;
 	ent->avelocity[2] = random() * 200;
 	ent->think = G_FreeEdict;
-	ent->nextthink = level.time + 30;
+	G_SetNextThink(ent, level.time + 30);
 	gi.linkentity(ent);
 }
 
@@ -2194,7 +2194,7 @@ SP_misc_gib_head(edict_t *ent)
 	ent->avelocity[1] = random() * 200;
 	ent->avelocity[2] = random() * 200;
 	ent->think = G_FreeEdict;
-	ent->nextthink = level.time + 30;
+	G_SetNextThink(ent, level.time + 30);
 	gi.linkentity(ent);
 }
 
@@ -2471,7 +2471,7 @@ func_clock_think(edict_t *self)
 		if (!(self->spawnflags & 8))
 		{
 			self->think = G_FreeEdict;
-			self->nextthink = level.time + 1;
+			G_SetNextThink(self, level.time + 1);
 			return;
 		}
 
@@ -2483,7 +2483,7 @@ func_clock_think(edict_t *self)
 		}
 	}
 
-	self->nextthink = level.time + 1;
+	G_SetNextThink(self, level.time + 1);
 }
 
 void
@@ -2549,7 +2549,7 @@ SP_func_clock(edict_t *self)
 	}
 	else
 	{
-		self->nextthink = level.time + 1;
+		G_SetNextThink(self, level.time + 1);
 	}
 }
 
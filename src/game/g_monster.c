@@ -183,7 +183,7 @@ M_FliesOn(edict_t *self)
 	self->s.effects |= EF_FLIES;
 	self->s.sound = gi.soundindex("infantry/inflies1.wav");
 	self->think = M_FliesOff;
-	self->nextthink = level.time + 60;
+	G_SetNextThink(self, level.time + 60);
 }
 
 void
@@ -205,7 +205,7 @@ M_FlyCheck(edict_t *self)
 	}
 
 	self->think = M_FliesOn;
-	self->nextthink = level.time + 5 + 10 * random();
+	G_SetNextThink(self, level.time + 5 + 10 * random());
 }
 
 void
@@ -521,7 +521,7 @@ M_MoveFrame(edict_t *self)
 	}
 
 	move = self->monsterinfo.currentmove;
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink(self, level.time + FRAMETIME);
 
 	if ((self->monsterinfo.nextframe) &&
 		(self->monsterinfo.nextframe >= move->firstframe) &&
@@ -690,7 +690,7 @@ monster_triggered_spawn_use(edict_t *self, edict_t *other /* unused */, edict_t
 	/* we have a one frame delay here so we
 	   don't telefrag the guy who activated us */
 	self->think = monster_triggered_spawn;
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink(self, level.time + FRAMETIME);
 
 	if (activator->client)
 	{
@@ -776,7 +776,7 @@ monster_start(edict_t *self)
 		level.total_monsters++;
 	}
 
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink(self, level.time + FRAMETIME);
 	self->svflags |= SVF_MONSTER;
 	self->s.renderfx |= RF_FRAMELERP;
 	self->takedamage = DAMAGE_AIM;
@@ -928,7 +928,7 @@ monster_start_go(edict_t *self)
 	}
 
 	self->think = monster_think;
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink(self, level.time + FRAMETIME);
 }
 
 void
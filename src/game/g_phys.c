@@ -32,6 +32,7 @@
 #define STOPSPEED 100
 #define FRICTION 6
 #define WATERFRICTION 1
+#define THINK_WHEEL 256 /* frames, a power of two */
 
 /*
  * pushmove objects do not obey gravity, and do not interact
@@ -102,6 +103,178 @@ SV_CheckVelocity(edict_t *ent)
 	}
 }
 
+/*
+ * The think scheduler. Every edict with a nextthink set
+ * through G_SetNextThink() sits in the wheel slot of the
+ * frame it's due in, or a little earlier. When that
+ * frame starts it's flagged, and only flagged edicts
+ * without physics are run. nextthink stays authoritative,
+ * SV_RunThink() checks it like it always did, the wheel
+ * only says when that's worth it. Entries are dropped
+ * when nextthink changed behind the wheel's back, so
+ * clearing it by assignment or memset is fine.
+ */
+typedef struct
+{
+	float time; /* the nextthink it was queued for */
+	int frame;
+	qboolean due;
+} thinkslot_t;
+
+static edictlist_t think_wheel[THINK_WHEEL];
+static edictlink_t *think_links;
+static thinkslot_t *think_slots;
+
+static void
+G_UnlinkThink(int num)
+{
+	G_EdictListRemove(&think_wheel[think_slots[num].frame & (THINK_WHEEL - 1)],
+			think_links, num);
+}
+
+static void
+G_LinkThink(int num, int frame)
+{
+	edictlist_t *list;
+
+	list = &think_wheel[frame & (THINK_WHEEL - 1)];
+	think_slots[num].frame = frame;
+	G_EdictListInsert(list, think_links, num, list->head);
+}
+
+void
+G_InitThinks(void)
+{
+	think_links = G_AllocEdictLinks();
+	think_slots = gi.TagMalloc(game.maxentities * sizeof(think_slots[0]),
+			TAG_GAME);
+}
+
+/*
+ * Requeues every edict
+ */
+void
+G_ResetThinks(void)
+{
+	edict_t *ent;
+	int i;
+
+	G_ClearEdictLinks(think_links);
+	memset(think_slots, 0, game.maxentities * sizeof(think_slots[0]));
+
+	for (i = 0; i < THINK_WHEEL; i++)
+	{
+		G_ClearEdictList(&think_wheel[i]);
+	}
+
+	for (i = 0, ent = g_edicts; i < globals.num_edicts; i++, ent++)
+	{
+		if (ent->inuse && (ent->nextthink > 0))
+		{
+			G_SetNextThink(ent, ent->nextthink);
+		}
+	}
+}
+
+void
+G_SetNextThink(edict_t *ent, float time)
+{
+	thinkslot_t *t;
+	int num, frame;
+
+	ent->nextthink = time;
+
+	num = ent - g_edicts;
+	t = &think_slots[num];
+
+	G_UnlinkThink(num);
+	t->time = time;
+	t->due = false;
+
+	if (time <= 0)
+	{
+		return;
+	}
+
+	/* due now, it thinks when its turn comes */
+	if (time <= level.time + 0.001)
+	{
+		t->due = true;
+		return;
+	}
+
+	/* rather a frame early than late */
+	frame = (int)((time - 0.001) / FRAMETIME);
+
+	if (frame <= level.framenum)
+	{
+		frame = level.framenum + 1;
+	}
+
+	G_LinkThink(num, frame);
+}
+
+/*
+ * Flags the edicts due this frame,
+ * called once level.time is set.
+ */
+void
+G_AdvanceThinks(void)
+{
+	thinkslot_t *t;
+	edict_t *ent;
+	int num, next;
+
+	for (num = think_wheel[level.framenum & (THINK_WHEEL - 1)].head;
+		 num >= 0; num = next)
+	{
+		t = &think_slots[num];
+		next = think_links[num].next;
+
+		if (t->frame > level.framenum)
+		{
+			continue; /* a later lap */
+		}
+
+		G_UnlinkThink(num);
+		ent = &g_edicts[num];
+
+		if (!ent->inuse || (ent->nextthink != t->time))
+		{
+			continue;
+		}
+
+		if (ent->nextthink <= level.time + 0.001)
+		{
+			t->due = true;
+		}
+		else
+		{
+			G_LinkThink(num, level.framenum + 1);
+		}
+	}
+}
+
+/*
+ * True if the edict may have to think
+ * now, clears the flag
+ */
+qboolean
+G_ThinkDue(edict_t *ent)
+{
+	thinkslot_t *t;
+
+	t = &think_slots[ent - g_edicts];
+
+	if (!t->due)
+	{
+		return false;
+	}
+
+	t->due = false;
+	return true;
+}
+
 /*
  * Runs thinking code for
  * this frame if necessary
@@ -819,7 +992,7 @@ SV_Physics_Pusher(edict_t *ent)
 		{
 			if (mv->nextthink > 0)
 			{
-				mv->nextthink += FRAMETIME;
+				G_SetNextThink(mv, mv->nextthink + FRAMETIME);
 			}
 		}
 
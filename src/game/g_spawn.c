@@ -268,6 +268,27 @@ spawn_t spawns[] = {
 	{NULL, NULL}
 };
 
+#define SPAWN_COUNT (sizeof(spawns) / sizeof(spawns[0]) - 1)
+
+static tableindex_t spawn_index;
+static int spawn_next[SPAWN_COUNT];
+
+/*
+ * Hashes the spawn function table
+ */
+void
+InitSpawns(void)
+{
+	int i;
+
+	G_ClearTableIndex(&spawn_index, spawn_next);
+
+	for (i = 0; i < SPAWN_COUNT; i++)
+	{
+		G_AddTableIndex(&spawn_index, i, Q_strhash(spawns[i].name));
+	}
+}
+
 /*
  * Finds the spawn function for
  * the entity and calls it
@@ -291,25 +312,23 @@ ED_CallSpawn(edict_t *ent)
 		return;
 	}
 
-	/* check item spawn functions */
-	for (i = 0, item = itemlist; i < game.num_items; i++, item++)
-	{
-		if (!item->classname)
-		{
-			continue;
-		}
+	/* check item spawn functions, the item
+	   lookup ignores case but spawning doesn't */
+	item = FindItemByClassname(ent->classname);
 
-		if (!strcmp(item->classname, ent->classname))
-		{
-			/* found it */
-			SpawnItem(ent, item);
-			return;
-		}
+	if (item && !strcmp(item->classname, ent->classname))
+	{
+		/* found it */
+		SpawnItem(ent, item);
+		return;
 	}
 
 	/* check normal spawn functions */
-	for (s = spawns; s->name; s++)
+	for (i = G_TableIndexFirst(&spawn_index, Q_strhash(ent->classname));
+		 i >= 0; i = spawn_next[i])
 	{
+		s = &spawns[i];
+
 		if (!strcmp(s->name, ent->classname))
 		{
 			/* found it */
@@ -488,6 +507,8 @@ ED_ParseEdict(char *data, edict_t *ent)
 		memset(ent, 0, sizeof(*ent));
 	}
 
+	G_IndexEdict(ent);
+
 	return data;
 }
 
@@ -601,6 +622,7 @@ SpawnEntities(const char *mapname, char *entities, const char *spawnpoint)
 
 	memset(&level, 0, sizeof(level));
 	memset(g_edicts, 0, game.maxentities * sizeof(g_edicts[0]));
+	G_ResetEdictTables();
 
 	Q_strlcpy(level.mapname, mapname, sizeof(level.mapname));
 	Q_strlcpy(game.spawnpoint, spawnpoint, sizeof(game.spawnpoint));
@@ -855,6 +877,7 @@ SP_worldspawn(edict_t *ent)
 	ent->movetype = MOVETYPE_PUSH;
 	ent->solid = SOLID_BSP;
 	ent->inuse = true; /* since the world doesn't use G_Spawn() */
+	G_IndexEdict(ent);
 	ent->s.modelindex = 1; /* world model is always index 1 */
 
 	/* --------------- */
@@ -344,6 +344,10 @@ ServerCommand(void)
 	{
 		SVCmd_WriteIP_f();
 	}
+	else if (Q_stricmp(cmd, "edictstats") == 0)
+	{
+		G_EdictStats();
+	}
 	else
 	{
 		gi.cprintf(NULL, PRINT_HIGH, "Unknown server command \"%s\"\n", cmd);
@@ -387,7 +387,7 @@ use_target_explosion(edict_t *self, edict_t *other /* unused */, edict_t *activa
 	}
 
 	self->think = target_explosion_explode;
-	self->nextthink = level.time + self->delay;
+	G_SetNextThink(self, level.time + self->delay);
 }
 
 void
@@ -572,7 +572,7 @@ use_target_spawner(edict_t *self, edict_t *other /* unused */, edict_t *activato
 	}
 
 	ent = G_Spawn();
-	ent->classname = self->target;
+	G_SetClassname(ent, self->target);
 	VectorCopy(self->s.origin, ent->s.origin);
 	VectorCopy(self->s.angles, ent->s.angles);
 	ED_CallSpawn(ent);
@@ -740,7 +740,7 @@ SP_target_crosslevel_target(edict_t *self)
 	self->svflags = SVF_NOCLIENT;
 
 	self->think = target_crosslevel_target_think;
-	self->nextthink = level.time + self->delay;
+	G_SetNextThink(self, level.time + self->delay);
 }
 
 /* ========================================================== */
@@ -842,7 +842,7 @@ target_laser_think(edict_t *self)
 
 	VectorCopy(tr.endpos, self->s.old_origin);
 
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink(self, level.time + FRAMETIME);
 }
 
 void
@@ -996,7 +996,7 @@ SP_target_laser(edict_t *self)
 
 	/* let everything else get spawned before we start firing */
 	self->think = target_laser_start;
-	self->nextthink = level.time + 1;
+	G_SetNextThink(self, level.time + 1);
 }
 
 /* ========================================================== */
@@ -1023,7 +1023,7 @@ target_lightramp_think(edict_t *self)
 
 	if ((level.time - self->timestamp) < self->speed)
 	{
-		self->nextthink = level.time + FRAMETIME;
+		G_SetNextThink(self, level.time + FRAMETIME);
 	}
 	else if (self->spawnflags & 1)
 	{
@@ -1181,7 +1181,7 @@ target_earthquake_think(edict_t *self)
 
 	if (level.time < self->timestamp)
 	{
-		self->nextthink = level.time + FRAMETIME;
+		G_SetNextThink(self, level.time + FRAMETIME);
 	}
 }
 
@@ -1194,7 +1194,7 @@ target_earthquake_use(edict_t *self, edict_t *other /* unused */, edict_t *activ
 	}
 
 	self->timestamp = level.time + self->count;
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink(self, level.time + FRAMETIME);
 	self->activator = activator;
 	self->last_move_time = 0;
 }
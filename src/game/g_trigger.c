@@ -89,7 +89,7 @@ multi_trigger(edict_t *ent)
 	if (ent->wait > 0)
 	{
 		ent->think = multi_wait;
-		ent->nextthink = level.time + ent->wait;
+		G_SetNextThink(ent, level.time + ent->wait);
 	}
 	else
 	{
@@ -98,7 +98,7 @@ multi_trigger(edict_t *ent)
 		   called while looping through area
 		   links... */
 		ent->touch = NULL;
-		ent->nextthink = level.time + FRAMETIME;
+		G_SetNextThink(ent, level.time + FRAMETIME);
 		ent->think = G_FreeEdict;
 	}
 }
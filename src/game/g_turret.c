@@ -253,7 +253,7 @@ turret_breach_think(edict_t *self)
 
 	VectorScale(delta, 1.0 / FRAMETIME, self->avelocity);
 
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink(self, level.time + FRAMETIME);
 
 	for (ent = self->teammaster; ent; ent = ent->teamchain)
 	{
@@ -378,7 +378,7 @@ SP_turret_breach(edict_t *self)
 	self->blocked = turret_blocked;
 
 	self->think = turret_breach_finish_init;
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink(self, level.time + FRAMETIME);
 	gi.linkentity(self);
 }
 
@@ -451,7 +451,7 @@ turret_driver_think(edict_t *self)
 		return;
 	}
 
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink(self, level.time + FRAMETIME);
 
 	if (self->enemy && (!self->enemy->inuse || (self->enemy->health <= 0)))
 	{
@@ -520,7 +520,7 @@ turret_driver_link(edict_t *self)
 	}
 
 	self->think = turret_driver_think;
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink(self, level.time + FRAMETIME);
 
 	self->target_ent = G_PickTarget(self->target);
 	self->target_ent->owner = self;
@@ -603,7 +603,7 @@ SP_turret_driver(edict_t *self)
 	}
 
 	self->think = turret_driver_link;
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink(self, level.time + FRAMETIME);
 
 	gi.linkentity(self);
 }
@@ -27,6 +27,7 @@
 #include "header/local.h"
 
 #define MAXCHOICES 8
+#define FIND_HASH 256 /* buckets per indexed field, a power of two */
 
 void
 G_ProjectSource(vec3_t point, vec3_t distance, vec3_t forward,
@@ -38,6 +39,258 @@ G_ProjectSource(vec3_t point, vec3_t distance, vec3_t forward,
 				distance[2];
 }
 
+/*
+ * Doubly linked lists of edicts, threaded through a
+ * links array indexed by edict number. The side tables
+ * here and in g_phys.c keep per edict state this way,
+ * as edict_t is shared with the server and can't grow.
+ */
+edictlink_t *
+G_AllocEdictLinks(void)
+{
+	return gi.TagMalloc(game.maxentities * sizeof(edictlink_t), TAG_GAME);
+}
+
+void
+G_ClearEdictLinks(edictlink_t *links)
+{
+	memset(links, 0, game.maxentities * sizeof(edictlink_t));
+}
+
+void
+G_ClearEdictList(edictlist_t *list)
+{
+	list->head = list->tail = -1;
+	list->count = 0;
+}
+
+/*
+ * Links the edict in front of before, or
+ * at the tail if before is -1. The edict
+ * mustn't be linked in the list already.
+ */
+void
+G_EdictListInsert(edictlist_t *list, edictlink_t *links, int num, int before)
+{
+	edictlink_t *l;
+
+	l = &links[num];
+	l->next = before;
+	l->prev = (before >= 0) ? links[before].prev : list->tail;
+
+	if (l->prev >= 0)
+	{
+		links[l->prev].next = num;
+	}
+	else
+	{
+		list->head = num;
+	}
+
+	if (before >= 0)
+	{
+		links[before].prev = num;
+	}
+	else
+	{
+		list->tail = num;
+	}
+
+	l->linked = true;
+	list->count++;
+}
+
+void
+G_EdictListRemove(edictlist_t *list, edictlink_t *links, int num)
+{
+	edictlink_t *l;
+
+	l = &links[num];
+
+	if (!l->linked)
+	{
+		return;
+	}
+
+	if (l->prev >= 0)
+	{
+		links[l->prev].next = l->next;
+	}
+	else
+	{
+		list->head = l->next;
+	}
+
+	if (l->next >= 0)
+	{
+		links[l->next].prev = l->prev;
+	}
+	else
+	{
+		list->tail = l->prev;
+	}
+
+	l->linked = false;
+	list->count--;
+}
+
+/*
+ * Hash indexes over the game's fixed tables, built once
+ * by InitGame(). Entries must be added in table order.
+ * The chains keep that order, so the first match in a
+ * chain is the one a linear search of the table finds.
+ */
+void
+G_ClearTableIndex(tableindex_t *index, int *next)
+{
+	memset(index->buckets, -1, sizeof(index->buckets));
+	index->next = next;
+}
+
+void
+G_AddTableIndex(tableindex_t *index, int entry, unsigned hash)
+{
+	int *link;
+
+	link = &index->buckets[hash & (TABLE_HASH - 1)];
+
+	while (*link >= 0)
+	{
+		link = &index->next[*link];
+	}
+
+	index->next[entry] = -1;
+	*link = entry;
+}
+
+int
+G_TableIndexFirst(tableindex_t *index, unsigned hash)
+{
+	return index->buckets[hash & (TABLE_HASH - 1)];
+}
+
+/*
+ * G_Find() on classname and targetname goes through an index.
+ * Every edict in use is in the bucket of its lower case name,
+ * and the buckets are sorted by edict number, the order
+ * G_Find() used to visit them in. The names must be set
+ * with G_SetClassname() and G_SetTargetname(), or the edict
+ * reindexed with G_IndexEdict() after writing them directly.
+ */
+static const int find_fields[] = {
+	FOFS(classname),
+	FOFS(targetname)
+};
+
+#define FIND_FIELDS (sizeof(find_fields) / sizeof(find_fields[0]))
+
+static edictlist_t find_buckets[FIND_FIELDS][FIND_HASH];
+static edictlink_t *find_links[FIND_FIELDS];
+static int *find_bucketof[FIND_FIELDS]; /* of the linked edicts */
+
+static void
+G_UnindexField(int field, int num)
+{
+	G_EdictListRemove(&find_buckets[field][find_bucketof[field][num]],
+			find_links[field], num);
+}
+
+static void
+G_IndexField(int field, edict_t *ent)
+{
+	edictlink_t *links;
+	edictlist_t *list;
+	int num, next, bucket;
+	char *s;
+
+	num = ent - g_edicts;
+	links = find_links[field];
+
+	G_UnindexField(field, num);
+
+	s = *(char **)((byte *)ent + find_fields[field]);
+
+	if (!ent->inuse || !s)
+	{
+		return;
+	}
+
+	bucket = Q_strhash(s) & (FIND_HASH - 1);
+	find_bucketof[field][num] = bucket;
+	list = &find_buckets[field][bucket];
+
+	/* keep the bucket sorted by edict number */
+	for (next = list->head; next >= 0 && next < num; next = links[next].next)
+	{
+	}
+
+	G_EdictListInsert(list, links, num, next);
+}
+
+/*
+ * Updates the index after the
+ * edict's names were changed
+ */
+void
+G_IndexEdict(edict_t *ent)
+{
+	int i;
+
+	for (i = 0; i < FIND_FIELDS; i++)
+	{
+		G_IndexField(i, ent);
+	}
+}
+
+void
+G_SetClassname(edict_t *ent, char *classname)
+{
+	ent->classname = classname;
+	G_IndexEdict(ent);
+}
+
+void
+G_SetTargetname(edict_t *ent, char *targetname)
+{
+	ent->targetname = targetname;
+	G_IndexEdict(ent);
+}
+
+static void
+G_InitFind(void)
+{
+	int i;
+
+	for (i = 0; i < FIND_FIELDS; i++)
+	{
+		find_links[i] = G_AllocEdictLinks();
+		find_bucketof[i] = gi.TagMalloc(game.maxentities * sizeof(int),
+				TAG_GAME);
+	}
+}
+
+static void
+G_ResetFind(void)
+{
+	int i, j;
+
+	for (i = 0; i < FIND_FIELDS; i++)
+	{
+		G_ClearEdictLinks(find_links[i]);
+		memset(find_bucketof[i], 0, game.maxentities * sizeof(int));
+
+		for (j = 0; j < FIND_HASH; j++)
+		{
+			G_ClearEdictList(&find_buckets[i][j]);
+		}
+	}
+
+	for (i = 0; i < globals.num_edicts; i++)
+	{
+		G_IndexEdict(&g_edicts[i]);
+	}
+}
+
 /*
  * Searches all active entities for the next
  * one that holds the matching string at fieldofs
@@ -50,7 +303,10 @@ G_ProjectSource(vec3_t point, vec3_t distance, vec3_t forward,
 edict_t *
 G_Find(edict_t *from, int fieldofs, char *match)
 {
+	edictlink_t *links;
+	edict_t *ent;
 	char *s;
+	int field, bucket, num;
 
 	if (!from)
 	{
@@ -66,6 +322,49 @@ G_Find(edict_t *from, int fieldofs, char *match)
 		return NULL;
 	}
 
+	for (field = 0; field < FIND_FIELDS; field++)
+	{
+		if (find_fields[field] == fieldofs)
+		{
+			break;
+		}
+	}
+
+	if (field < FIND_FIELDS)
+	{
+		links = find_links[field];
+		bucket = Q_strhash(match) & (FIND_HASH - 1);
+		num = from - g_edicts;
+
+		/* loops continue right after the last match */
+		if ((num > 0) && links[num - 1].linked &&
+			(find_bucketof[field][num - 1] == bucket))
+		{
+			num = links[num - 1].next;
+		}
+		else
+		{
+			for (num = find_buckets[field][bucket].head;
+				 num >= 0 && g_edicts + num < from;
+				 num = links[num].next)
+			{
+			}
+		}
+
+		for ( ; num >= 0 && num < globals.num_edicts; num = links[num].next)
+		{
+			ent = &g_edicts[num];
+			s = *(char **)((byte *)ent + fieldofs);
+
+			if (ent->inuse && s && !Q_stricmp(s, match))
+			{
+				return ent;
+			}
+		}
+
+		return NULL;
+	}
+
 	for ( ; from < &g_edicts[globals.num_edicts]; from++)
 	{
 		if (!from->inuse)
@@ -89,49 +388,129 @@ G_Find(edict_t *from, int fieldofs, char *match)
 	return NULL;
 }
 
-/*
- * Returns entities that have origins
- * within a spherical area
- */
-edict_t *
-findradius(edict_t *from, vec3_t org, float rad)
+static qboolean
+G_InRadius(edict_t *ent, vec3_t org, float rad)
 {
 	vec3_t eorg;
 	int j;
 
-	if (!from)
+	if (!ent->inuse)
 	{
-		from = g_edicts;
+		return false;
 	}
-	else
+
+	if (ent->solid == SOLID_NOT)
 	{
-		from++;
+		return false;
 	}
 
-	for ( ; from < &g_edicts[globals.num_edicts]; from++)
+	for (j = 0; j < 3; j++)
 	{
-		if (!from->inuse)
+		eorg[j] = org[j] - (ent->s.origin[j] +
+				   (ent->mins[j] + ent->maxs[j]) * 0.5);
+	}
+
+	return VectorLength(eorg) <= rad;
+}
+
+static int
+G_CompareEdicts(const void *a, const void *b)
+{
+	return *(edict_t **)a - *(edict_t **)b;
+}
+
+/* the candidates of the last findradius() query */
+static edict_t *radius_list[MAX_EDICTS];
+static int radius_count, radius_next;
+static vec3_t radius_org;
+static float radius_rad;
+
+/*
+ * Returns entities that have origins
+ * within a spherical area
+ *
+ * The candidates come from the server's area
+ * tree, by the abs box each edict had when it was
+ * last linked. An edict moved without a call to
+ * gi.linkentity() since is looked for at its old
+ * place, and missed if that's out of range. The
+ * distance test uses the current origin, so it's
+ * never found at a place it has left. Edicts that
+ * were never linked are missed as well. The
+ * candidates are sorted, so they come in edict
+ * order like they used to. A loop over the results
+ * continues in the list, any other call starts a
+ * new query.
+ */
+edict_t *
+findradius(edict_t *from, vec3_t org, float rad)
+{
+	vec3_t mins, maxs;
+	edict_t *ent;
+	int i;
+
+	if (g_linear_findradius->value)
+	{
+		if (!from)
 		{
-			continue;
+			from = g_edicts;
+		}
+		else
+		{
+			from++;
 		}
 
-		if (from->solid == SOLID_NOT)
+		for ( ; from < &g_edicts[globals.num_edicts]; from++)
 		{
-			continue;
+			if (G_InRadius(from, org, rad))
+			{
+				return from;
+			}
 		}
 
-		for (j = 0; j < 3; j++)
+		return NULL;
+	}
+
+	if (!from || (radius_next == 0) || (radius_list[radius_next - 1] != from) ||
+		!VectorCompare(org, radius_org) || (rad != radius_rad))
+	{
+		for (i = 0; i < 3; i++)
 		{
-			eorg[j] = org[j] - (from->s.origin[j] +
-					   (from->mins[j] + from->maxs[j]) * 0.5);
+			mins[i] = org[i] - rad;
+			maxs[i] = org[i] + rad;
 		}
 
-		if (VectorLength(eorg) > rad)
+		/* the world isn't linked */
+		radius_list[0] = g_edicts;
+		radius_count = 1;
+
+		radius_count += gi.BoxEdicts(mins, maxs, radius_list + radius_count,
+				MAX_EDICTS - radius_count, AREA_SOLID);
+		radius_count += gi.BoxEdicts(mins, maxs, radius_list + radius_count,
+				MAX_EDICTS - radius_count, AREA_TRIGGERS);
+
+		qsort(radius_list, radius_count, sizeof(radius_list[0]),
+				G_CompareEdicts);
+
+		VectorCopy(org, radius_org);
+		radius_rad = rad;
+		radius_next = 0;
+
+		while (from && (radius_next < radius_count) &&
+			   (radius_list[radius_next] <= from))
 		{
-			continue;
+			radius_next++;
 		}
+	}
 
-		return from;
+	while (radius_next < radius_count)
+	{
+		ent = radius_list[radius_next++];
+
+		if (G_InRadius(ent, org, rad))
+		{
+			return ent;
+		}
 	}
 
 	return NULL;
@@ -226,8 +605,8 @@ G_UseTargets(edict_t *ent, edict_t *activator)
 	{
 		/* create a temp object to fire at a later time */
 		t = G_Spawn();
-		t->classname = "DelayedUse";
-		t->nextthink = level.time + ent->delay;
+		G_SetClassname(t, "DelayedUse");
+		G_SetNextThink(t, level.time + ent->delay);
 		t->think = Think_Delay;
 		t->activator = activator;
 
@@ -493,11 +872,129 @@ void
 G_InitEdict(edict_t *e)
 {
 	e->inuse = true;
-	e->classname = "noclass";
+	G_SetClassname(e, "noclass");
 	e->gravity = 1.0;
 	e->s.number = e - g_edicts;
 }
 
+/*
+ * Freed edicts wait in a queue in the
+ * order they were freed, so the oldest
+ * one is always at the head. Edicts in
+ * use are never in the queue.
+ */
+static edictlist_t free_queue;
+static edictlink_t *free_links;
+
+static struct
+{
+	int spawns;
+	int reused;
+	int delayed; /* the oldest free edict was too fresh */
+	int frees;
+	int peak;
+} edict_stats;
+
+static int
+G_CompareFreetime(const void *a, const void *b)
+{
+	const edict_t *e1, *e2;
+
+	e1 = &g_edicts[*(const int *)a];
+	e2 = &g_edicts[*(const int *)b];
+
+	if (e1->freetime != e2->freetime)
+	{
+		return (e1->freetime < e2->freetime) ? -1 : 1;
+	}
+
+	return *(const int *)a - *(const int *)b;
+}
+
+static void
+G_InitFree(void)
+{
+	free_links = G_AllocEdictLinks();
+}
+
+/*
+ * Also starts new statistics for the map
+ */
+static void
+G_ResetFree(void)
+{
+	int *list;
+	int i, count;
+
+	G_ClearEdictLinks(free_links);
+	G_ClearEdictList(&free_queue);
+	memset(&edict_stats, 0, sizeof(edict_stats));
+
+	list = gi.TagMalloc(game.maxentities * sizeof(int), TAG_GAME);
+	count = 0;
+
+	for (i = maxclients->value + 1; i < globals.num_edicts; i++)
+	{
+		if (!g_edicts[i].inuse)
+		{
+			list[count++] = i;
+		}
+	}
+
+	qsort(list, count, sizeof(list[0]), G_CompareFreetime);
+
+	for (i = 0; i < count; i++)
+	{
+		G_EdictListInsert(&free_queue, free_links, list[i], -1);
+	}
+
+	gi.TagFree(list);
+
+	edict_stats.peak = globals.num_edicts - free_queue.count;
+}
+
+/*
+ * Allocates the side tables for game.maxentities
+ * edicts, right after g_edicts was allocated
+ */
+void
+G_InitEdictTables(void)
+{
+	G_InitThinks();
+	G_InitFind();
+	G_InitFree();
+
+	G_ResetEdictTables();
+}
+
+/*
+ * Rebuilds the side tables from the edicts,
+ * for a new level or one read from a savegame
+ */
+void
+G_ResetEdictTables(void)
+{
+	G_ResetThinks();
+	G_ResetFind();
+	G_ResetFree();
+}
+
+/*
+ * Prints how the edict pool
+ * was used on this map
+ */
+void
+G_EdictStats(void)
+{
+	gi.cprintf(NULL, PRINT_HIGH, "%i of %i edicts allocated, %i free\n",
+			globals.num_edicts, game.maxentities, free_queue.count);
+	gi.cprintf(NULL, PRINT_HIGH, "%i in use, peak %i\n",
+			globals.num_edicts - free_queue.count, edict_stats.peak);
+	gi.cprintf(NULL, PRINT_HIGH, "%i spawns, %i reused, %i delayed, %i frees\n",
+			edict_stats.spawns, edict_stats.reused, edict_stats.delayed,
+			edict_stats.frees);
+}
+
 /*
  * Either finds a free edict, or allocates a
  * new one.  Try to avoid reusing an entity
@@ -510,31 +1007,46 @@ G_InitEdict(edict_t *e)
 edict_t *
 G_Spawn(void)
 {
-	int i;
 	edict_t *e;
 
-	e = &g_edicts[(int)maxclients->value + 1];
+	edict_stats.spawns++;
 
-	for (i = maxclients->value + 1; i < globals.num_edicts; i++, e++)
+	/* the oldest free edict is the only
+	   candidate, all others were freed
+	   after it */
+	if (free_queue.head >= 0)
 	{
+		e = &g_edicts[free_queue.head];
+
 		/* the first couple seconds of
 		   server time can involve a lot of
 		   freeing and allocating, so relax
 		   the replacement policy */
-		if (!e->inuse && ((e->freetime < 2) || (level.time - e->freetime > 0.5)))
+		if ((e->freetime < 2) || (level.time - e->freetime > 0.5))
 		{
+			G_EdictListRemove(&free_queue, free_links, free_queue.head);
+			edict_stats.reused++;
 			G_InitEdict(e);
 			return e;
 		}
+
+		edict_stats.delayed++;
 	}
 
-	if (i == game.maxentities)
+	if (globals.num_edicts == game.maxentities)
 	{
 		gi.error("ED_Alloc: no free edicts");
 	}
 
+	e = &g_edicts[globals.num_edicts];
 	globals.num_edicts++;
 	G_InitEdict(e);
+
+	if (globals.num_edicts - free_queue.count > edict_stats.peak)
+	{
+		edict_stats.peak = globals.num_edicts - free_queue.count;
+	}
+
 	return e;
 }
 
@@ -565,6 +1077,10 @@ G_FreeEdict(edict_t *ed)
 	ed->classname = "freed";
 	ed->freetime = level.time;
 	ed->inuse = false;
+	G_IndexEdict(ed);
+	G_EdictListRemove(&free_queue, free_links, ed - g_edicts);
+	G_EdictListInsert(&free_queue, free_links, ed - g_edicts, -1);
+	edict_stats.frees++;
 }
 
 void
@@ -166,135 +166,109 @@ fire_hit(edict_t *self, vec3_t aim, int damage, int kick)
 	return true;
 }
 
+/* pellets traced together by fire_shotgun() */
+#define MAX_PELLETS 32
+
 /*
- * This is an internal support routine
- * used for bullet/pellet based weapons.
+ * A bullet or pellet entered water at tr->endpos.
+ * Splashes, changes its course and traces on
+ * ignoring water this time.
  */
-void
-fire_lead(edict_t *self, vec3_t start, vec3_t aimdir, int damage, int kick,
-		int te_impact, int hspread, int vspread, int mod)
+static void
+fire_lead_water(edict_t *self, vec3_t start, vec3_t end, trace_t *tr,
+		vec3_t water_start, int hspread, int vspread)
 {
-	trace_t tr;
 	vec3_t dir;
 	vec3_t forward, right, up;
-	vec3_t end;
 	float r;
 	float u;
-	vec3_t water_start;
-	qboolean water = false;
-	int content_mask = MASK_SHOT | MASK_WATER;
+	int color;
 
-	if (!self)
-	{
-		return;
-	}
+	VectorCopy(tr->endpos, water_start);
 
-	tr = gi.trace(self->s.origin, NULL, NULL, start, self, MASK_SHOT);
-
-	if (!(tr.fraction < 1.0))
+	if (!VectorCompare(start, tr->endpos))
 	{
-		vectoangles(aimdir, dir);
-		AngleVectors(dir, forward, right, up);
-
-		r = crandom() * hspread;
-		u = crandom() * vspread;
-		VectorMA(start, 8192, forward, end);
-		VectorMA(end, r, right, end);
-		VectorMA(end, u, up, end);
-
-		if (gi.pointcontents(start) & MASK_WATER)
+		if (tr->contents & CONTENTS_WATER)
 		{
-			water = true;
-			VectorCopy(start, water_start);
-			content_mask &= ~MASK_WATER;
-		}
-
-		tr = gi.trace(start, NULL, NULL, end, self, content_mask);
-
-		/* see if we hit water */
-		if (tr.contents & MASK_WATER)
-		{
-			int color;
-
-			water = true;
-			VectorCopy(tr.endpos, water_start);
-
-			if (!VectorCompare(start, tr.endpos))
+			if (strcmp(tr->surface->name, "*brwater") == 0)
 			{
-				if (tr.contents & CONTENTS_WATER)
-				{
-					if (strcmp(tr.surface->name, "*brwater") == 0)
-					{
-						color = SPLASH_BROWN_WATER;
-					}
-					else
-					{
-						color = SPLASH_BLUE_WATER;
-					}
-				}
-				else if (tr.contents & CONTENTS_SLIME)
-				{
-					color = SPLASH_SLIME;
-				}
-				else if (tr.contents & CONTENTS_LAVA)
-				{
-					color = SPLASH_LAVA;
-				}
-				else
-				{
-					color = SPLASH_UNKNOWN;
-				}
-
-				if (color != SPLASH_UNKNOWN)
-				{
-					gi.WriteByte(svc_temp_entity);
-					gi.WriteByte(TE_SPLASH);
-					gi.WriteByte(8);
-					gi.WritePosition(tr.endpos);
-					gi.WriteDir(tr.plane.normal);
-					gi.WriteByte(color);
-					gi.multicast(tr.endpos, MULTICAST_PVS);
-				}
-
-				/* change bullet's course when it enters water */
-				VectorSubtract(end, start, dir);
-				vectoangles(dir, dir);
-				AngleVectors(dir, forward, right, up);
-				r = crandom() * hspread * 2;
-				u = crandom() * vspread * 2;
-				VectorMA(water_start, 8192, forward, end);
-				VectorMA(end, r, right, end);
-				VectorMA(end, u, up, end);
+				color = SPLASH_BROWN_WATER;
 			}
+			else
+			{
+				color = SPLASH_BLUE_WATER;
+			}
+		}
+		else if (tr->contents & CONTENTS_SLIME)
+		{
+			color = SPLASH_SLIME;
+		}
+		else if (tr->contents & CONTENTS_LAVA)
+		{
+			color = SPLASH_LAVA;
+		}
+		else
+		{
+			color = SPLASH_UNKNOWN;
+		}
 
-			/* re-trace ignoring water this time */
-			tr = gi.trace(water_start, NULL, NULL, end, self, MASK_SHOT);
+		if (color != SPLASH_UNKNOWN)
+		{
+			gi.WriteByte(svc_temp_entity);
+			gi.WriteByte(TE_SPLASH);
+			gi.WriteByte(8);
+			gi.WritePosition(tr->endpos);
+			gi.WriteDir(tr->plane.normal);
+			gi.WriteByte(color);
+			gi.multicast(tr->endpos, MULTICAST_PVS);
 		}
+
+		/* change bullet's course when it enters water */
+		VectorSubtract(end, start, dir);
+		vectoangles(dir, dir);
+		AngleVectors(dir, forward, right, up);
+		r = crandom() * hspread * 2;
+		u = crandom() * vspread * 2;
+		VectorMA(water_start, 8192, forward, end);
+		VectorMA(end, r, right, end);
+		VectorMA(end, u, up, end);
 	}
 
+	/* re-trace ignoring water this time */
+	*tr = gi.trace(water_start, NULL, NULL, end, self, MASK_SHOT);
+}
+
+/*
+ * Damages whatever the bullet or pellet hit, or
+ * sends the gun puff, and draws its bubble trail.
+ */
+static void
+fire_lead_impact(edict_t *self, vec3_t aimdir, trace_t *tr, qboolean water,
+		vec3_t water_start, int damage, int kick, int te_impact, int mod)
+{
 	/* send gun puff / flash */
-	if (!((tr.surface) && (tr.surface->flags & SURF_SKY)))
+	if (!((tr->surface) && (tr->surface->flags & SURF_SKY)))
 	{
-		if (tr.fraction < 1.0)
+		if (tr->fraction < 1.0)
 		{
-			if (tr.ent->takedamage)
+			if (tr->ent->takedamage)
 			{
-				T_Damage(tr.ent, self, self, aimdir, tr.endpos, tr.plane.normal,
-						damage, kick, DAMAGE_BULLET, mod);
+				T_Damage(tr->ent, self, self, aimdir, tr->endpos,
+						tr->plane.normal, damage, kick, DAMAGE_BULLET, mod);
 			}
 			else
 			{
-				if (strncmp(tr.surface->name, "sky", 3) != 0)
+				if (strncmp(tr->surface->name, "sky", 3) != 0)
 				{
 					gi.WriteByte(svc_temp_entity);
 					gi.WriteByte(te_impact);
-					gi.WritePosition(tr.endpos);
-					gi.WriteDir(tr.plane.normal);
-					gi.multicast(tr.endpos, MULTICAST_PVS);
+					gi.WritePosition(tr->endpos);
+					gi.WriteDir(tr->plane.normal);
+					gi.multicast(tr->endpos, MULTICAST_PVS);
 
 					if (self->client)
 					{
-						PlayerNoise(self, tr.endpos, PNOISE_IMPACT);
+						PlayerNoise(self, tr->endpos, PNOISE_IMPACT);
 					}
 				}
 			}
@@ -305,32 +279,91 @@ fire_lead(edict_t *self, vec3_t start, vec3_t aimdir, int damage, int kick,
 	   where the end and make a bubble trail */
 	if (water)
 	{
+		vec3_t dir;
 		vec3_t pos;
 
-		VectorSubtract(tr.endpos, water_start, dir);
+		VectorSubtract(tr->endpos, water_start, dir);
 		VectorNormalize(dir);
-		VectorMA(tr.endpos, -2, dir, pos);
+		VectorMA(tr->endpos, -2, dir, pos);
 
 		if (gi.pointcontents(pos) & MASK_WATER)
 		{
-			VectorCopy(pos, tr.endpos);
+			VectorCopy(pos, tr->endpos);
 		}
 		else
 		{
-			tr = gi.trace(pos, NULL, NULL, water_start, tr.ent, MASK_WATER);
+			*tr = gi.trace(pos, NULL, NULL, water_start, tr->ent, MASK_WATER);
 		}
 
-		VectorAdd(water_start, tr.endpos, pos);
+		VectorAdd(water_start, tr->endpos, pos);
 		VectorScale(pos, 0.5, pos);
 
 		gi.WriteByte(svc_temp_entity);
 		gi.WriteByte(TE_BUBBLETRAIL);
 		gi.WritePosition(water_start);
-		gi.WritePosition(tr.endpos);
+		gi.WritePosition(tr->endpos);
 		gi.multicast(pos, MULTICAST_PVS);
 	}
 }
 
+/*
+ * This is an internal support routine
+ * used for bullet/pellet based weapons.
+ */
+void
+fire_lead(edict_t *self, vec3_t start, vec3_t aimdir, int damage, int kick,
+		int te_impact, int hspread, int vspread, int mod)
+{
+	trace_t tr;
+	vec3_t dir;
+	vec3_t forward, right, up;
+	vec3_t end;
+	float r;
+	float u;
+	vec3_t water_start;
+	qboolean water = false;
+	int content_mask = MASK_SHOT | MASK_WATER;
+
+	if (!self)
+	{
+		return;
+	}
+
+	tr = gi.trace(self->s.origin, NULL, NULL, start, self, MASK_SHOT);
+
+	if (!(tr.fraction < 1.0))
+	{
+		vectoangles(aimdir, dir);
+		AngleVectors(dir, forward, right, up);
+
+		r = crandom() * hspread;
+		u = crandom() * vspread;
+		VectorMA(start, 8192, forward, end);
+		VectorMA(end, r, right, end);
+		VectorMA(end, u, up, end);
+
+		if (gi.pointcontents(start) & MASK_WATER)
+		{
+			water = true;
+			VectorCopy(start, water_start);
+			content_mask &= ~MASK_WATER;
+		}
+
+		tr = gi.trace(start, NULL, NULL, end, self, content_mask);
+
+		/* see if we hit water */
+		if (tr.contents & MASK_WATER)
+		{
+			water = true;
+			fire_lead_water(self, start, end, &tr, water_start,
+					hspread, vspread);
+		}
+	}
+
+	fire_lead_impact(self, aimdir, &tr, water, water_start, damage, kick,
+			te_impact, mod);
+}
+
 /*
  * Fires a single round.  Used for machinegun and
  * chaingun.  Would be fine for pistols, rifles, etc....
@@ -356,17 +389,101 @@ void
 fire_shotgun(edict_t *self, vec3_t start, vec3_t aimdir, int damage,
 		int kick, int hspread, int vspread, int count, int mod)
 {
-	int i;
+	trace_t tr;
+	trace_t traces[MAX_PELLETS];
+	vec3_t starts[MAX_PELLETS], ends[MAX_PELLETS];
+	int linkcounts[MAX_PELLETS];
+	vec3_t dir;
+	vec3_t forward, right, up;
+	vec3_t water_start;
+	float r;
+	float u;
+	qboolean inwater = false;
+	qboolean water;
+	int content_mask = MASK_SHOT | MASK_WATER;
+	int i, j, n;
 
 	if (!self)
 	{
 		return;
 	}
 
-	for (i = 0; i < count; i++)
+	/* something between the shooter and the muzzle
+	   takes all pellets, no point in batching them */
+	tr = gi.trace(self->s.origin, NULL, NULL, start, self, MASK_SHOT);
+
+	if (tr.fraction < 1.0)
+	{
+		for (i = 0; i < count; i++)
+		{
+			fire_lead(self, start, aimdir, damage, kick, TE_SHOTGUN,
+					hspread, vspread, mod);
+		}
+
+		return;
+	}
+
+	if (gi.pointcontents(start) & MASK_WATER)
+	{
+		inwater = true;
+		content_mask &= ~MASK_WATER;
+	}
+
+	vectoangles(aimdir, dir);
+	AngleVectors(dir, forward, right, up);
+
+	for (i = 0; i < count; i += n)
 	{
-		fire_lead(self, start, aimdir, damage, kick, TE_SHOTGUN,
-				hspread, vspread, mod);
+		n = count - i;
+
+		if (n > MAX_PELLETS)
+		{
+			n = MAX_PELLETS;
+		}
+
+		for (j = 0; j < n; j++)
+		{
+			r = crandom() * hspread;
+			u = crandom() * vspread;
+			VectorCopy(start, starts[j]);
+			VectorMA(start, 8192, forward, ends[j]);
+			VectorMA(ends[j], r, right, ends[j]);
+			VectorMA(ends[j], u, up, ends[j]);
+		}
+
+		gi.multitrace(n, starts, ends, NULL, NULL, self, content_mask,
+				traces);
+
+		for (j = 0; j < n; j++)
+		{
+			linkcounts[j] = traces[j].ent->linkcount;
+		}
+
+		for (j = 0; j < n; j++)
+		{
+			tr = traces[j];
+
+			/* an earlier pellet may have killed,
+			   gibbed or moved what this one hit */
+			if (!tr.ent->inuse || (tr.ent->linkcount != linkcounts[j]))
+			{
+				tr = gi.trace(start, NULL, NULL, ends[j], self, content_mask);
+			}
+
+			water = inwater;
+			VectorCopy(start, water_start);
+
+			/* see if we hit water */
+			if (tr.contents & MASK_WATER)
+			{
+				water = true;
+				fire_lead_water(self, start, ends[j], &tr, water_start,
+						hspread, vspread);
+			}
+
+			fire_lead_impact(self, aimdir, &tr, water, water_start, damage,
+					kick, TE_SHOTGUN, mod);
+		}
 	}
 }
 
@@ -481,10 +598,10 @@ fire_blaster(edict_t *self, vec3_t start, vec3_t dir, int damage,
 	bolt->s.sound = gi.soundindex("misc/lasfly.wav");
 	bolt->owner = self;
 	bolt->touch = blaster_touch;
-	bolt->nextthink = level.time + 2;
+	G_SetNextThink(bolt, level.time + 2);
 	bolt->think = G_FreeEdict;
 	bolt->dmg = damage;
-	bolt->classname = "bolt";
+	G_SetClassname(bolt, "bolt");
 
 	if (hyper)
 	{
@@ -674,11 +791,11 @@ fire_grenade(edict_t *self, vec3_t start, vec3_t aimdir, int damage, int speed,
 	grenade->s.modelindex = gi.modelindex("models/objects/grenade/tris.md2");
 	grenade->owner = self;
 	grenade->touch = Grenade_Touch;
-	grenade->nextthink = level.time + timer;
+	G_SetNextThink(grenade, level.time + timer);
 	grenade->think = Grenade_Explode;
 	grenade->dmg = damage;
 	grenade->dmg_radius = damage_radius;
-	grenade->classname = "grenade";
+	G_SetClassname(grenade, "grenade");
 
 	gi.linkentity(grenade);
 }
@@ -714,11 +831,11 @@ fire_grenade2(edict_t *self, vec3_t start, vec3_t aimdir, int damage,
 	grenade->s.modelindex = gi.modelindex("models/objects/grenade2/tris.md2");
 	grenade->owner = self;
 	grenade->touch = Grenade_Touch;
-	grenade->nextthink = level.time + timer;
+	G_SetNextThink(grenade, level.time + timer);
 	grenade->think = Grenade_Explode;
 	grenade->dmg = damage;
 	grenade->dmg_radius = damage_radius;
-	grenade->classname = "hgrenade";
+	G_SetClassname(grenade, "hgrenade");
 
 	if (held)
 	{
@@ -851,13 +968,13 @@ fire_rocket(edict_t *self, vec3_t start, vec3_t dir, int damage,
 	rocket->s.modelindex = gi.modelindex("models/objects/rocket/tris.md2");
 	rocket->owner = self;
 	rocket->touch = rocket_touch;
-	rocket->nextthink = level.time + 8000 / speed;
+	G_SetNextThink(rocket, level.time + 8000 / speed);
 	rocket->think = G_FreeEdict;
 	rocket->dmg = damage;
 	rocket->radius_dmg = radius_damage;
 	rocket->dmg_radius = damage_radius;
 	rocket->s.sound = gi.soundindex("weapons/rockfly.wav");
-	rocket->classname = "rocket";
+	G_SetClassname(rocket, "rocket");
 
 	if (self->client)
 	{
@@ -1005,7 +1122,7 @@ bfg_explode(edict_t *self)
 		}
 	}
 
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink(self, level.time + FRAMETIME);
 	self->s.frame++;
 
 	if (self->s.frame == 5)
@@ -1067,7 +1184,7 @@ bfg_touch(edict_t *self, edict_t *other, cplane_t *plane, csurface_t *surf)
 	self->s.sound = 0;
 	self->s.effects &= ~EF_ANIM_ALLFAST;
 	self->think = bfg_explode;
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink(self, level.time + FRAMETIME);
 	self->enemy = other;
 
 	gi.WriteByte(svc_temp_entity);
@@ -1178,7 +1295,7 @@ bfg_think(edict_t *self)
 		gi.multicast(self->s.origin, MULTICAST_PHS);
 	}
 
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink(self, level.time + FRAMETIME);
 }
 
 void
@@ -1206,15 +1323,15 @@ fire_bfg(edict_t *self, vec3_t start, vec3_t dir, int damage,
 	bfg->s.modelindex = gi.modelindex("sprites/s_bfg1.sp2");
 	bfg->owner = self;
 	bfg->touch = bfg_touch;
-	bfg->nextthink = level.time + 8000 / speed;
+	G_SetNextThink(bfg, level.time + 8000 / speed);
 	bfg->think = G_FreeEdict;
 	bfg->radius_dmg = damage;
 	bfg->dmg_radius = damage_radius;
-	bfg->classname = "bfg blast";
+	G_SetClassname(bfg, "bfg blast");
 	bfg->s.sound = gi.soundindex("weapons/bfg__l1a.wav");
 
 	bfg->think = bfg_think;
-	bfg->nextthink = level.time + FRAMETIME;
+	G_SetNextThink(bfg, level.time + FRAMETIME);
 	bfg->teammaster = bfg;
 	bfg->teamchain = NULL;
 
@@ -34,7 +34,12 @@
  * !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
  */
 
-#define GAME_API_VERSION 3
+/* 4 appended multitrace to game_import_t. Engines that only
+   know version 3 refuse this game instead of handing it an
+   import without that slot, while this engine still loads
+   version 3 games, which never look past DebugGraph. */
+#define GAME_API_VERSION 4
+#define GAME_API_VERSION_MIN 3
 
 #define SVF_NOCLIENT 0x00000001 /* don't send entity to clients, even if it has effects */
 #define SVF_DEADMONSTER 0x00000002 /* treat as CONTENTS_DEADMONSTER for collision */
@@ -181,6 +186,13 @@ typedef struct
 	void (*AddCommandString)(char *text);
 
 	void (*DebugGraph)(float value, int color);
+
+	/* count traces sharing size, passent and contentmask, cheaper
+	   than count calls to trace. Last, so that older game modules
+	   still find everything else where they expect it. */
+	void (*multitrace)(int count, vec3_t *starts, vec3_t *ends,
+			vec3_t mins, vec3_t maxs, edict_t *passent, int contentmask,
+			trace_t *results);
 } game_import_t;
 
 /* functions exported by the game subsystem */
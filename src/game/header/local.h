@@ -530,6 +530,7 @@ extern cvar_t *flood_persecond;
 extern cvar_t *flood_waitdelay;
 
 extern cvar_t *sv_maplist;
+extern cvar_t *g_linear_findradius;
 
 #define world (&g_edicts[0])
 
@@ -574,6 +575,29 @@ typedef struct
 extern field_t fields[];
 extern gitem_t itemlist[];
 
+/* an edict's place in a list of edicts, the
+   links of a list are indexed by edict number */
+typedef struct
+{
+	int prev, next;
+	qboolean linked;
+} edictlink_t;
+
+typedef struct
+{
+	int head, tail;
+	int count;
+} edictlist_t;
+
+/* a hash index over a fixed table, see G_AddTableIndex() */
+#define TABLE_HASH 1024 /* a power of two */
+
+typedef struct
+{
+	int buckets[TABLE_HASH];
+	int *next; /* one per table entry */
+} tableindex_t;
+
 /* g_cmds.c */
 void Cmd_Help_f(edict_t *ent);
 
@@ -597,11 +621,29 @@ gitem_t *GetItemByIndex(int index);
 qboolean Add_Ammo(edict_t *ent, gitem_t *item, int count);
 void Touch_Item(edict_t *ent, edict_t *other, cplane_t *plane, csurface_t *surf);
 
+/* g_spawn.c */
+void InitSpawns(void);
+
 /* g_utils.c */
 qboolean KillBox(edict_t *ent);
 void G_ProjectSource(vec3_t point, vec3_t distance, vec3_t forward,
 		vec3_t right, vec3_t result);
 edict_t *G_Find(edict_t *from, int fieldofs, char *match);
+edictlink_t *G_AllocEdictLinks(void);
+void G_ClearEdictLinks(edictlink_t *links);
+void G_ClearEdictList(edictlist_t *list);
+void G_EdictListInsert(edictlist_t *list, edictlink_t *links, int num,
+		int before);
+void G_EdictListRemove(edictlist_t *list, edictlink_t *links, int num);
+void G_ClearTableIndex(tableindex_t *index, int *next);
+void G_AddTableIndex(tableindex_t *index, int entry, unsigned hash);
+int G_TableIndexFirst(tableindex_t *index, unsigned hash);
+void G_InitEdictTables(void);
+void G_ResetEdictTables(void);
+void G_IndexEdict(edict_t *ent);
+void G_SetClassname(edict_t *ent, char *classname);
+void G_SetTargetname(edict_t *ent, char *targetname);
+void G_EdictStats(void);
 edict_t *findradius(edict_t *from, vec3_t org, float rad);
 edict_t *G_PickTarget(char *targetname);
 void G_UseTargets(edict_t *ent, edict_t *activator);
@@ -768,6 +810,11 @@ void M_ChangeYaw(edict_t *ent);
 
 /* g_phys.c */
 void G_RunEntity(edict_t *ent);
+void G_InitThinks(void); /* for G_InitEdictTables() */
+void G_ResetThinks(void); /* for G_ResetEdictTables() */
+void G_SetNextThink(edict_t *ent, float time);
+void G_AdvanceThinks(void);
+qboolean G_ThinkDue(edict_t *ent);
 
 /* g_main.c */
 void SaveClientData(void);
@@ -59,7 +59,7 @@ Think_Boss3Stand(edict_t *ent)
 		ent->s.frame++;
 	}
 
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink(ent, level.time + FRAMETIME);
 }
 
 /*
@@ -94,6 +94,6 @@ SP_monster_boss3_stand(edict_t *self)
 
 	self->use = Use_Boss3;
 	self->think = Think_Boss3Stand;
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink(self, level.time + FRAMETIME);
 	gi.linkentity(self);
 }
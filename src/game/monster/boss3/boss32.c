@@ -835,12 +835,12 @@ makron_torso_think(edict_t *self)
 
 	if (++self->s.frame < 365)
 	{
-		self->nextthink = level.time + FRAMETIME;
+		G_SetNextThink(self, level.time + FRAMETIME);
 	}
 	else
 	{
 		self->s.frame = 346;
-		self->nextthink = level.time + FRAMETIME;
+		G_SetNextThink(self, level.time + FRAMETIME);
 	}
 }
 
@@ -859,7 +859,7 @@ makron_torso(edict_t *ent)
 	ent->s.frame = 346;
 	ent->s.modelindex = gi.modelindex("models/monsters/boss3/rider/tris.md2");
 	ent->think = makron_torso_think;
-	ent->nextthink = level.time + 2 * FRAMETIME;
+	G_SetNextThink(ent, level.time + 2 * FRAMETIME);
 	ent->s.sound = gi.soundindex("makron/spine.wav");
 	gi.linkentity(ent);
 }
@@ -1163,7 +1163,7 @@ MakronToss(edict_t *self)
 	}
 
 	ent = G_Spawn();
-	ent->nextthink = level.time + 0.8;
+	G_SetNextThink(ent, level.time + 0.8);
 	ent->think = MakronSpawn;
 	ent->target = self->target;
 	VectorCopy(self->s.origin, ent->s.origin);
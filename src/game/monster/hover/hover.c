@@ -697,7 +697,7 @@ hover_deadthink(edict_t *self)
 
 	if (!self->groundentity && (level.time < self->timestamp))
 	{
-		self->nextthink = level.time + FRAMETIME;
+		G_SetNextThink(self, level.time + FRAMETIME);
 		return;
 	}
 
@@ -716,7 +716,7 @@ hover_dead(edict_t *self)
 	VectorSet(self->maxs, 16, 16, -8);
 	self->movetype = MOVETYPE_TOSS;
 	self->think = hover_deadthink;
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink(self, level.time + FRAMETIME);
 	self->timestamp = level.time + 15;
 	gi.linkentity(self);
 }
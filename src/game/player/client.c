@@ -74,7 +74,7 @@ SP_FixCoopSpots(edict_t *self)
 		{
 			if ((!self->targetname) || (Q_stricmp(self->targetname, spot->targetname) != 0))
 			{
-				self->targetname = spot->targetname;
+				G_SetTargetname(self, spot->targetname);
 			}
 
 			return;
@@ -101,27 +101,27 @@ SP_CreateCoopSpots(edict_t *self)
 	if (Q_stricmp(level.mapname, "security") == 0)
 	{
 		spot = G_Spawn();
-		spot->classname = "info_player_coop";
+		G_SetClassname(spot, "info_player_coop");
 		spot->s.origin[0] = 188 - 64;
 		spot->s.origin[1] = -164;
 		spot->s.origin[2] = 80;
-		spot->targetname = "jail3";
+		G_SetTargetname(spot, "jail3");
 		spot->s.angles[1] = 90;
 
 		spot = G_Spawn();
-		spot->classname = "info_player_coop";
+		G_SetClassname(spot, "info_player_coop");
 		spot->s.origin[0] = 188 + 64;
 		spot->s.origin[1] = -164;
 		spot->s.origin[2] = 80;
-		spot->targetname = "jail3";
+		G_SetTargetname(spot, "jail3");
 		spot->s.angles[1] = 90;
 
 		spot = G_Spawn();
-		spot->classname = "info_player_coop";
+		G_SetClassname(spot, "info_player_coop");
 		spot->s.origin[0] = 188 + 128;
 		spot->s.origin[1] = -164;
 		spot->s.origin[2] = 80;
-		spot->targetname = "jail3";
+		G_SetTargetname(spot, "jail3");
 		spot->s.angles[1] = 90;
 
 		return;
@@ -152,12 +152,12 @@ SP_CreateUnnamedSpawn(edict_t *self)
 	{
 		if (Q_stricmp(self->targetname, "mintro") == 0)
 		{
-			spot->classname = self->classname;
+			G_SetClassname(spot, self->classname);
 			spot->s.origin[0] = self->s.origin[0];
 			spot->s.origin[1] = self->s.origin[1];
 			spot->s.origin[2] = self->s.origin[2];
 			spot->s.angles[1] = self->s.angles[1];
-			spot->targetname = NULL;
+			G_SetTargetname(spot, NULL);
 
 			return;
 		}
@@ -168,12 +168,12 @@ SP_CreateUnnamedSpawn(edict_t *self)
 	{
 		if (Q_stricmp(self->targetname, "mine1") == 0)
 		{
-			spot->classname = self->classname;
+			G_SetClassname(spot, self->classname);
 			spot->s.origin[0] = self->s.origin[0];
 			spot->s.origin[1] = self->s.origin[1];
 			spot->s.origin[2] = self->s.origin[2];
 			spot->s.angles[1] = self->s.angles[1];
-			spot->targetname = NULL;
+			G_SetTargetname(spot, NULL);
 
 			return;
 		}
@@ -184,12 +184,12 @@ SP_CreateUnnamedSpawn(edict_t *self)
 	{
 		if (Q_stricmp(self->targetname, "mine2a") == 0)
 		{
-			spot->classname = self->classname;
+			G_SetClassname(spot, self->classname);
 			spot->s.origin[0] = self->s.origin[0];
 			spot->s.origin[1] = self->s.origin[1];
 			spot->s.origin[2] = self->s.origin[2];
 			spot->s.angles[1] = self->s.angles[1];
-			spot->targetname = NULL;
+			G_SetTargetname(spot, NULL);
 
 			return;
 		}
@@ -200,12 +200,12 @@ SP_CreateUnnamedSpawn(edict_t *self)
 	{
 		if (Q_stricmp(self->targetname, "mine3") == 0)
 		{
-			spot->classname = self->classname;
+			G_SetClassname(spot, self->classname);
 			spot->s.origin[0] = self->s.origin[0];
 			spot->s.origin[1] = self->s.origin[1];
 			spot->s.origin[2] = self->s.origin[2];
 			spot->s.angles[1] = self->s.angles[1];
-			spot->targetname = NULL;
+			G_SetTargetname(spot, NULL);
 
 			return;
 		}
@@ -216,12 +216,12 @@ SP_CreateUnnamedSpawn(edict_t *self)
 	{
 		if (Q_stricmp(self->targetname, "power1") == 0)
 		{
-			spot->classname = self->classname;
+			G_SetClassname(spot, self->classname);
 			spot->s.origin[0] = self->s.origin[0];
 			spot->s.origin[1] = self->s.origin[1];
 			spot->s.origin[2] = self->s.origin[2];
 			spot->s.angles[1] = self->s.angles[1];
-			spot->targetname = NULL;
+			G_SetTargetname(spot, NULL);
 
 			return;
 		}
@@ -232,12 +232,12 @@ SP_CreateUnnamedSpawn(edict_t *self)
 	{
 		if (Q_stricmp(self->targetname, "power2") == 0)
 		{
-			spot->classname = self->classname;
+			G_SetClassname(spot, self->classname);
 			spot->s.origin[0] = self->s.origin[0];
 			spot->s.origin[1] = self->s.origin[1];
 			spot->s.origin[2] = self->s.origin[2];
 			spot->s.angles[1] = self->s.angles[1];
-			spot->targetname = NULL;
+			G_SetTargetname(spot, NULL);
 
 			return;
 		}
@@ -248,12 +248,12 @@ SP_CreateUnnamedSpawn(edict_t *self)
 	{
 		if (Q_stricmp(self->targetname, "waste1") == 0)
 		{
-			spot->classname = self->classname;
+			G_SetClassname(spot, self->classname);
 			spot->s.origin[0] = self->s.origin[0];
 			spot->s.origin[1] = self->s.origin[1];
 			spot->s.origin[2] = self->s.origin[2];
 			spot->s.angles[1] = self->s.angles[1];
-			spot->targetname = NULL;
+			G_SetTargetname(spot, NULL);
 
 			return;
 		}
@@ -264,12 +264,12 @@ SP_CreateUnnamedSpawn(edict_t *self)
 	{
 		if (Q_stricmp(self->targetname, "waste2") == 0)
 		{
-			spot->classname = self->classname;
+			G_SetClassname(spot, self->classname);
 			spot->s.origin[0] = self->s.origin[0];
 			spot->s.origin[1] = self->s.origin[1];
 			spot->s.origin[2] = self->s.origin[2];
 			spot->s.angles[1] = self->s.angles[1];
-			spot->targetname = NULL;
+			G_SetTargetname(spot, NULL);
 
 			return;
 		}
@@ -280,12 +280,12 @@ SP_CreateUnnamedSpawn(edict_t *self)
 	{
 		if (Q_stricmp(self->targetname, "city2NL") == 0)
 		{
-			spot->classname = self->classname;
+			G_SetClassname(spot, self->classname);
 			spot->s.origin[0] = self->s.origin[0];
 			spot->s.origin[1] = self->s.origin[1];
 			spot->s.origin[2] = self->s.origin[2];
 			spot->s.angles[1] = self->s.angles[1];
-			spot->targetname = NULL;
+			G_SetTargetname(spot, NULL);
 
 			return;
 		}
@@ -306,7 +306,7 @@ SP_info_player_start(edict_t *self)
 
     /* Call function to hack unnamed spawn points */
 	self->think = SP_CreateUnnamedSpawn;
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink(self, level.time + FRAMETIME);
 
 	if (!coop->value)
 	{
@@ -317,7 +317,7 @@ SP_info_player_start(edict_t *self)
 	{
 		/* invoke one of our gross, ugly, disgusting hacks */
 		self->think = SP_CreateCoopSpots;
-		self->nextthink = level.time + FRAMETIME;
+		G_SetNextThink(self, level.time + FRAMETIME);
 	}
 }
 
@@ -381,7 +381,7 @@ SP_info_player_coop(edict_t *self)
 	{
 		/* invoke one of our gross, ugly, disgusting hacks */
 		self->think = SP_FixCoopSpots;
-		self->nextthink = level.time + FRAMETIME;
+		G_SetNextThink(self, level.time + FRAMETIME);
 	}
 }
 
@@ -789,9 +789,9 @@ TossClientWeapon(edict_t *self)
 		drop->spawnflags |= DROPPED_PLAYER_ITEM;
 
 		drop->touch = Touch_Item;
-		drop->nextthink = level.time +
-						  (self->client->quad_framenum -
-						   level.framenum) * FRAMETIME;
+		G_SetNextThink(drop, level.time +
+				(self->client->quad_framenum -
+				 level.framenum) * FRAMETIME);
 		drop->think = G_FreeEdict;
 	}
 }
@@ -1415,7 +1415,7 @@ InitBodyQue(void)
 		for (i = 0; i < BODY_QUEUE_SIZE; i++)
 		{
 			ent = G_Spawn();
-			ent->classname = "bodyque";
+			G_SetClassname(ent, "bodyque");
 		}
 	}
 }
@@ -1711,7 +1711,7 @@ PutClientInServer(edict_t *ent)
 	ent->movetype = MOVETYPE_WALK;
 	ent->viewheight = 22;
 	ent->inuse = true;
-	ent->classname = "player";
+	G_SetClassname(ent, "player");
 	ent->mass = 200;
 	ent->solid = SOLID_BBOX;
 	ent->deadflag = DEAD_NO;
@@ -1895,7 +1895,7 @@ ClientBegin(edict_t *ent)
 		   except for the persistant data that was initialized at
 		   ClientConnect() time */
 		G_InitEdict(ent);
-		ent->classname = "player";
+		G_SetClassname(ent, "player");
 		InitClientResp(ent->client);
 		PutClientInServer(ent);
 	}
@@ -2133,7 +2133,7 @@ ClientDisconnect(edict_t *ent)
 	ent->s.modelindex = 0;
 	ent->solid = SOLID_NOT;
 	ent->inuse = false;
-	ent->classname = "disconnected";
+	G_SetClassname(ent, "disconnected");
 	ent->client->pers.connected = false;
 
 	playernum = ent - g_edicts - 1;
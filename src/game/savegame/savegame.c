@@ -192,6 +192,63 @@ field_t clientfields[] = {
 
 /* ========================================================= */
 
+/*
+ * The function and mmove_t lists are
+ * looked up by pointer and by name
+ * through indexes built by InitGame()
+ */
+#define FUNCTION_COUNT (sizeof(functionList) / sizeof(functionList[0]) - 1)
+#define MMOVE_COUNT (sizeof(mmoveList) / sizeof(mmoveList[0]) - 1)
+
+static tableindex_t func_adrindex;
+static int func_adrnext[FUNCTION_COUNT];
+static tableindex_t func_nameindex;
+static int func_namenext[FUNCTION_COUNT];
+static tableindex_t mmove_adrindex;
+static int mmove_adrnext[MMOVE_COUNT];
+static tableindex_t mmove_nameindex;
+static int mmove_namenext[MMOVE_COUNT];
+
+static unsigned
+HashAddress(void *adr)
+{
+	unsigned long long hash;
+
+	/* the high bits of the product are well mixed */
+	hash = (unsigned long long)(size_t)adr * 0x9e3779b97f4a7c15ull;
+
+	return (unsigned)(hash >> 32);
+}
+
+static void
+InitSaveTables(void)
+{
+	int i;
+
+	G_ClearTableIndex(&func_adrindex, func_adrnext);
+	G_ClearTableIndex(&func_nameindex, func_namenext);
+	G_ClearTableIndex(&mmove_adrindex, mmove_adrnext);
+	G_ClearTableIndex(&mmove_nameindex, mmove_namenext);
+
+	for (i = 0; i < FUNCTION_COUNT; i++)
+	{
+		G_AddTableIndex(&func_adrindex, i,
+				HashAddress(functionList[i].funcPtr));
+		G_AddTableIndex(&func_nameindex, i,
+				Q_strhash(functionList[i].funcStr));
+	}
+
+	for (i = 0; i < MMOVE_COUNT; i++)
+	{
+		G_AddTableIndex(&mmove_adrindex, i,
+				HashAddress(mmoveList[i].mmovePtr));
+		G_AddTableIndex(&mmove_nameindex, i,
+				Q_strhash(mmoveList[i].mmoveStr));
+	}
+}
+
+/* ========================================================= */
+
 /*
  * This will be called when the dll is first loaded,
  * which only happens when a new game is started or
@@ -248,8 +305,15 @@ InitGame(void)
 	/* dm map list */
 	sv_maplist = gi.cvar("sv_maplist", "", 0);
 
-	/* items */
+	/* 1 scans all edicts in findradius(), to compare */
+	g_linear_findradius = gi.cvar("g_linear_findradius", "0", 0);
+
+	/* items and spawn functions */
 	InitItems();
+	InitSpawns();
+
+	/* savegame lookups */
+	InitSaveTables();
 
 	game.helpmessage1[0] = 0;
 	game.helpmessage2[0] = 0;
@@ -259,6 +323,7 @@ InitGame(void)
 	g_edicts = gi.TagMalloc(game.maxentities * sizeof(g_edicts[0]), TAG_GAME);
 	globals.edicts = g_edicts;
 	globals.max_edicts = game.maxentities;
+	G_InitEdictTables();
 
 	/* initialize all clients for this game */
 	game.maxclients = maxclients->value;
@@ -280,7 +345,8 @@ GetFunctionByAddress(byte *adr)
 {
 	int i;
 
-	for (i = 0; functionList[i].funcStr; i++)
+	for (i = G_TableIndexFirst(&func_adrindex, HashAddress(adr)); i >= 0;
+		 i = func_adrnext[i])
 	{
 		if (functionList[i].funcPtr == adr)
 		{
@@ -303,7 +369,8 @@ FindFunctionByName(char *name)
 {
 	int i;
 
-	for (i = 0; functionList[i].funcStr; i++)
+	for (i = G_TableIndexFirst(&func_nameindex, Q_strhash(name)); i >= 0;
+		 i = func_namenext[i])
 	{
 		if (!strcmp(name, functionList[i].funcStr))
 		{
@@ -324,7 +391,8 @@ GetMmoveByAddress(mmove_t *adr)
 {
 	int i;
 
-	for (i = 0; mmoveList[i].mmoveStr; i++)
+	for (i = G_TableIndexFirst(&mmove_adrindex, HashAddress(adr)); i >= 0;
+		 i = mmove_adrnext[i])
 	{
 		if (mmoveList[i].mmovePtr == adr)
 		{
@@ -345,7 +413,8 @@ FindMmoveByName(char *name)
 {
 	int i;
 
-	for (i = 0; mmoveList[i].mmoveStr; i++)
+	for (i = G_TableIndexFirst(&mmove_nameindex, Q_strhash(name)); i >= 0;
+		 i = mmove_namenext[i])
 	{
 		if (!strcmp(name, mmoveList[i].mmoveStr))
 		{
@@ -851,6 +920,7 @@ ReadGame(const char *filename)
 
 	g_edicts = gi.TagMalloc(game.maxentities * sizeof(g_edicts[0]), TAG_GAME);
 	globals.edicts = g_edicts;
+	G_InitEdictTables();
 
 	fread(&game, sizeof(game), 1, f);
 	game.clients = gi.TagMalloc(game.maxclients * sizeof(game.clients[0]),
@@ -1092,6 +1162,8 @@ ReadLevel(const char *filename)
 		ent->client->pers.connected = false;
 	}
 
+	G_ResetEdictTables();
+
 	/* do any load time things at this point */
 	for (i = 0; i < globals.num_edicts; i++)
 	{
@@ -1107,7 +1179,7 @@ ReadLevel(const char *filename)
 		{
 			if (strcmp(ent->classname, "target_crosslevel_target") == 0)
 			{
-				ent->nextthink = level.time + ent->delay;
+				G_SetNextThink(ent, level.time + ent->delay);
 			}
 		}
 	}
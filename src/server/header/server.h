@@ -39,6 +39,11 @@
    out before legitimate users connected */
 #define MAX_CHALLENGES 1024
 
+/* number of buckets in the connected client
+   hash, keyed by base address and qport.
+   Must be a power of two. */
+#define CLIENT_HASH_SIZE 256
+
 #define SV_OUTPUTBUF_LENGTH (MAX_MSGLEN - 16)
 #define EDICT_NUM(n) ((edict_t *)((byte *)ge->edicts + ge->edict_size * (n)))
 #define NUM_FOR_EDICT(e) (((byte *)(e) - (byte *)ge->edicts) / ge->edict_size)
@@ -98,6 +103,18 @@ typedef struct
 	int senttime;                           /* for ping calculations */
 } client_frame_t;
 
+/* where a client's edict was last seen in the
+   BSP, see SV_ClientVis() */
+typedef struct
+{
+	qboolean valid;
+	int spawncount;                     /* svs.spawncount of the lookup */
+	vec3_t origin;                      /* edict origin of the lookup */
+	int leafnum;
+	int cluster;
+	int area;
+} clientvis_t;
+
 typedef struct client_s
 {
 	client_state_t state;
@@ -138,6 +155,10 @@ typedef struct client_s
 	int challenge;                      /* challenge of this user, randomly generated */
 
 	netchan_t netchan;
+
+	struct client_s *hashnext;          /* next client in the svs.client_hash bucket */
+
+	clientvis_t vis;                    /* cached leaf, cluster and area */
 } client_t;
 
 typedef struct
@@ -166,6 +187,12 @@ typedef struct
 
 	challenge_t challenges[MAX_CHALLENGES];    /* to prevent invalid IPs from connecting */
 
+	/* all non free clients, hashed by base address and qport */
+	client_t *client_hash[CLIENT_HASH_SIZE];
+	int clienthash_lookups;                    /* calls to SV_FindClient */
+	int clienthash_probes;                     /* bucket entries visited */
+	int clienthash_collisions;                 /* visited entries that didn't match */
+
 	/* serverrecord values */
 	FILE *demofile;
 	sizebuf_t demo_multicast;
@@ -186,6 +213,7 @@ extern cvar_t *sv_noreload;                 /* don't reload level state when ree
 extern cvar_t *sv_airaccelerate;            /* don't reload level state when reentering */
 											/* development tool */
 extern cvar_t *sv_enforcetime;
+extern cvar_t *sv_threads;                  /* threads building client frames */
 
 extern client_t *sv_client;
 extern edict_t *sv_player;
@@ -193,6 +221,10 @@ extern edict_t *sv_player;
 void SV_FinalMessage(char *message, qboolean reconnect);
 void SV_DropClient(client_t *drop);
 
+void SV_HashClient(client_t *cl);
+void SV_UnhashClient(client_t *cl);
+client_t *SV_FindClient(netadr_t adr, int qport);
+
 int SV_ModelIndex(char *name);
 int SV_SoundIndex(char *name);
 int SV_ImageIndex(char *name);
@@ -223,6 +255,9 @@ void SV_DemoCompleted(void);
 void SV_SendClientMessages(void);
 
 void SV_Multicast(vec3_t origin, multicast_t to);
+void SV_UpdateClientVis(void);
+clientvis_t *SV_ClientVis(client_t *cl);
+void SV_PointVis(vec3_t p, int *cluster, int *area);
 void SV_StartSound(vec3_t origin, edict_t *entity, int channel,
 		int soundindex, float volume, float attenuation,
 		float timeofs);
@@ -239,6 +274,7 @@ void SV_Status_f(void);
 void SV_WriteFrameToClient(client_t *client, sizebuf_t *msg);
 void SV_RecordDemoMessage(void);
 void SV_BuildClientFrame(client_t *client);
+void SV_BuildClientMessages(client_t **clients, sizebuf_t *msgs, int count);
 
 void SV_Error(char *error, ...);
 
@@ -278,5 +314,14 @@ int SV_PointContents(vec3_t p);
 trace_t SV_Trace(vec3_t start, vec3_t mins, vec3_t maxs,
 		vec3_t end, edict_t *passedict, int contentmask);
 
+/* prints the state of the area tree */
+void SV_AreaStats_f(void);
+
+/* rays traced together by SV_MultiTrace(), more are split up */
+#define MAX_MULTITRACE 32
+
+void SV_MultiTrace(int count, vec3_t *starts, vec3_t *ends, vec3_t mins,
+		vec3_t maxs, edict_t *passedict, int contentmask, trace_t *results);
+
 #endif
 
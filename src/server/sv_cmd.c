@@ -380,6 +380,53 @@ SV_Status_f(void)
 	Com_Printf("\n");
 }
 
+/*
+ * Prints statistics about the client address hash
+ */
+void
+SV_ClientHash_f(void)
+{
+	int i, used, longest, len;
+	client_t *cl;
+
+	if (!svs.clients)
+	{
+		Com_Printf("No server running.\n");
+		return;
+	}
+
+	used = 0;
+	longest = 0;
+
+	for (i = 0; i < CLIENT_HASH_SIZE; i++)
+	{
+		len = 0;
+
+		for (cl = svs.client_hash[i]; cl; cl = cl->hashnext)
+		{
+			len++;
+		}
+
+		if (len)
+		{
+			used++;
+		}
+
+		if (len > longest)
+		{
+			longest = len;
+		}
+	}
+
+	Com_Printf("buckets    : %i used of %i, longest chain %i\n",
+			used, CLIENT_HASH_SIZE, longest);
+	Com_Printf("lookups    : %i\n", svs.clienthash_lookups);
+	Com_Printf("probes     : %i (%.2f per lookup)\n", svs.clienthash_probes,
+			svs.clienthash_lookups ?
+			(float)svs.clienthash_probes / svs.clienthash_lookups : 0.0f);
+	Com_Printf("collisions : %i\n", svs.clienthash_collisions);
+}
+
 void
 SV_ConSay_f(void)
 {
@@ -616,6 +663,10 @@ SV_InitOperatorCommands(void)
 	Cmd_AddCommand("heartbeat", SV_Heartbeat_f);
 	Cmd_AddCommand("kick", SV_Kick_f);
 	Cmd_AddCommand("status", SV_Status_f);
+	Cmd_AddCommand("clienthash", SV_ClientHash_f);
+	Cmd_AddCommand("viscache", CM_VisCacheStats);
+	Cmd_AddCommand("cmbench", CMB_Bench_f);
+	Cmd_AddCommand("areastats", SV_AreaStats_f);
 	Cmd_AddCommand("serverinfo", SV_Serverinfo_f);
 	Cmd_AddCommand("dumpuser", SV_DumpUser_f);
 
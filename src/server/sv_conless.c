@@ -270,6 +270,10 @@ SVC_DirectConnect(void)
 
 gotnewcl:
 
+	/* a reused slot is rehashed once
+	   the new netchan has been set up */
+	SV_UnhashClient(newcl);
+
 	/* build a new connection  accept the new client this
 	   is the only place a client_t is ever initialized */
 	*newcl = temp;
@@ -306,6 +310,7 @@ gotnewcl:
 	Netchan_OutOfBandPrint(NS_SERVER, adr, "client_connect");
 
 	Netchan_Setup(NS_SERVER, &newcl->netchan, adr, qport);
+	SV_HashClient(newcl);
 
 	newcl->state = cs_connected;
 
@@ -28,7 +28,20 @@
 
 #include "header/server.h"
 
-byte fatpvs[65536 / 8];
+/* scratch space of a thread building client
+   frames, indexed by the job worker number */
+typedef struct
+{
+	byte fatpvs[65536 / 8];
+	byte phs[65536 / 8];
+	entity_state_t entities[MAX_EDICTS];
+} frame_scratch_t;
+
+static frame_scratch_t *frame_scratch[MAX_JOB_THREADS];
+
+/* the clients and messages of SV_BuildClientMessages() */
+static client_t **build_clients;
+static sizebuf_t *build_msgs;
 
 /*
  * Writes a delta update of an entity_state_t list to the message.
@@ -429,7 +442,7 @@ SV_WriteFrameToClient(client_t *client, sizebuf_t *msg)
  * so we can't use a single PVS point
  */
 void
-SV_FatPVS(vec3_t org)
+SV_FatPVS(vec3_t org, byte *fatpvs)
 {
 	int leafs[64];
 	int i, j, count;
@@ -480,17 +493,18 @@ SV_FatPVS(vec3_t org)
 
 		for (j = 0; j < longs; j++)
 		{
-			((long *)fatpvs)[j] |= ((long *)src)[j];
+			((int *)fatpvs)[j] |= ((int *)src)[j];
 		}
 	}
 }
 
 /*
  * Decides which entities are going to be visible to the client, and
- * copies off the playerstat and areabits.
+ * copies off the playerstat and areabits. May run on several threads
+ * at once, each with its own scratch space.
  */
-void
-SV_BuildClientFrame(client_t *client)
+static void
+SV_BuildFrame(client_t *client, frame_scratch_t *scratch)
 {
 	int e, i;
 	vec3_t org;
@@ -502,6 +516,7 @@ SV_BuildClientFrame(client_t *client)
 	int clientarea, clientcluster;
 	int leafnum;
 	int c_fullsend;
+	int count, first;
 	byte *clientphs;
 	byte *bitvector;
 
@@ -524,6 +539,10 @@ SV_BuildClientFrame(client_t *client)
 				 clent->client->ps.viewoffset[i];
 	}
 
+	/* leaf queries are reentrant, but
+	   the vis row cache is shared */
+	Sys_JobLock();
+
 	leafnum = CM_PointLeafnum(org);
 	clientarea = CM_LeafArea(leafnum);
 	clientcluster = CM_LeafCluster(leafnum);
@@ -531,15 +550,19 @@ SV_BuildClientFrame(client_t *client)
 	/* calculate the visible areas */
 	frame->areabytes = CM_WriteAreaBits(frame->areabits, clientarea);
 
+	SV_FatPVS(org, scratch->fatpvs);
+	memcpy(scratch->phs, CM_ClusterPHS(clientcluster),
+			(CM_NumClusters() + 7) >> 3);
+
+	Sys_JobUnlock();
+
 	/* grab the current player_state_t */
 	frame->ps = clent->client->ps;
 
-	SV_FatPVS(org);
-	clientphs = CM_ClusterPHS(clientcluster);
+	clientphs = scratch->phs;
 
 	/* build up the list of visible entities */
-	frame->num_entities = 0;
-	frame->first_entity = svs.next_client_entities;
+	count = 0;
 
 	c_fullsend = 0;
 
@@ -587,7 +610,7 @@ SV_BuildClientFrame(client_t *client)
 			}
 			else
 			{
-				bitvector = fatpvs;
+				bitvector = scratch->fatpvs;
 
 				if (ent->num_clusters == -1)
 				{
@@ -636,16 +659,15 @@ SV_BuildClientFrame(client_t *client)
 			}
 		}
 
-		/* add it to the circular client_entities array */
-		state = &svs.client_entities[svs.next_client_entities %
-				svs.num_client_entities];
-
+		/* SV_BuildClientMessages() fixes them up
+		   before any thread is started */
 		if (ent->s.number != e)
 		{
 			Com_DPrintf("FIXING ENT->S.NUMBER!!!\n");
 			ent->s.number = e;
 		}
 
+		state = &scratch->entities[count++];
 		*state = ent->s;
 
 		/* don't mark players missiles as solid */
@@ -653,10 +675,93 @@ SV_BuildClientFrame(client_t *client)
 		{
 			state->solid = 0;
 		}
+	}
+
+	/* reserve room in the circular client_entities
+	   array, other threads may do the same */
+	first = __sync_fetch_and_add(&svs.next_client_entities, count);
+
+	for (i = 0; i < count; i++)
+	{
+		svs.client_entities[(first + i) % svs.num_client_entities] =
+			scratch->entities[i];
+	}
+
+	frame->first_entity = first;
+	frame->num_entities = count;
+}
+
+static frame_scratch_t *
+SV_FrameScratch(int worker)
+{
+	if (!frame_scratch[worker])
+	{
+		frame_scratch[worker] = Z_Malloc(sizeof(frame_scratch_t));
+	}
+
+	return frame_scratch[worker];
+}
+
+void
+SV_BuildClientFrame(client_t *client)
+{
+	SV_BuildFrame(client, SV_FrameScratch(0));
+}
+
+static void
+SV_BuildClientMessage(int index, int worker)
+{
+	SV_BuildFrame(build_clients[index], frame_scratch[worker]);
+	SV_WriteFrameToClient(build_clients[index], &build_msgs[index]);
+}
+
+/*
+ * Builds the frames of several clients and writes them to
+ * the given messages. With sv_threads above 1 they're built
+ * on that many threads. The result is the same as calling
+ * SV_BuildClientFrame() and SV_WriteFrameToClient() for one
+ * client after another.
+ */
+void
+SV_BuildClientMessages(client_t **clients, sizebuf_t *msgs, int count)
+{
+	int threads;
+	edict_t *ent;
+	int e;
+
+	threads = (int)sv_threads->value;
+
+	if (threads < 1)
+	{
+		threads = 1;
+	}
+	else if (threads > MAX_JOB_THREADS)
+	{
+		threads = MAX_JOB_THREADS;
+	}
+
+	/* the worker threads mustn't write to the edicts */
+	for (e = 1; e < ge->num_edicts; e++)
+	{
+		ent = EDICT_NUM(e);
+
+		if (ent->s.number != e)
+		{
+			Com_DPrintf("FIXING ENT->S.NUMBER!!!\n");
+			ent->s.number = e;
+		}
+	}
 
-		svs.next_client_entities++;
-		frame->num_entities++;
+	/* the zone allocator isn't thread safe */
+	for (e = 0; e < threads; e++)
+	{
+		SV_FrameScratch(e);
 	}
+
+	build_clients = clients;
+	build_msgs = msgs;
+
+	Sys_RunJobs(count, threads, SV_BuildClientMessage);
 }
 
 /*
@@ -279,19 +279,14 @@ PF_WriteAngle(float f)
 qboolean
 PF_inPVS(vec3_t p1, vec3_t p2)
 {
-	int leafnum;
 	int cluster;
 	int area1, area2;
 	byte *mask;
 
-	leafnum = CM_PointLeafnum(p1);
-	cluster = CM_LeafCluster(leafnum);
-	area1 = CM_LeafArea(leafnum);
+	SV_PointVis(p1, &cluster, &area1);
 	mask = CM_ClusterPVS(cluster);
 
-	leafnum = CM_PointLeafnum(p2);
-	cluster = CM_LeafCluster(leafnum);
-	area2 = CM_LeafArea(leafnum);
+	SV_PointVis(p2, &cluster, &area2);
 
 	if (mask && (!(mask[cluster >> 3] & (1 << (cluster & 7)))))
 	{
@@ -312,19 +307,14 @@ PF_inPVS(vec3_t p1, vec3_t p2)
 qboolean
 PF_inPHS(vec3_t p1, vec3_t p2)
 {
-	int leafnum;
 	int cluster;
 	int area1, area2;
 	byte *mask;
 
-	leafnum = CM_PointLeafnum(p1);
-	cluster = CM_LeafCluster(leafnum);
-	area1 = CM_LeafArea(leafnum);
+	SV_PointVis(p1, &cluster, &area1);
 	mask = CM_ClusterPHS(cluster);
 
-	leafnum = CM_PointLeafnum(p2);
-	cluster = CM_LeafCluster(leafnum);
-	area2 = CM_LeafArea(leafnum);
+	SV_PointVis(p2, &cluster, &area2);
 
 	if (mask && (!(mask[cluster >> 3] & (1 << (cluster & 7)))))
 	{
@@ -398,6 +388,7 @@ SV_InitGameProgs(void)
 	import.unlinkentity = SV_UnlinkEdict;
 	import.BoxEdicts = SV_AreaEdicts;
 	import.trace = SV_Trace;
+	import.multitrace = SV_MultiTrace;
 	import.pointcontents = SV_PointContents;
 	import.setmodel = PF_setmodel;
 	import.inPVS = PF_inPVS;
@@ -449,10 +440,11 @@ SV_InitGameProgs(void)
 		Com_Error(ERR_DROP, "failed to load game DLL");
 	}
 
-	if (ge->apiversion != GAME_API_VERSION)
+	if ((ge->apiversion < GAME_API_VERSION_MIN) ||
+		(ge->apiversion > GAME_API_VERSION))
 	{
-		Com_Error(ERR_DROP, "game is version %i, not %i", ge->apiversion,
-				GAME_API_VERSION);
+		Com_Error(ERR_DROP, "game is version %i, not %i to %i",
+				ge->apiversion, GAME_API_VERSION_MIN, GAME_API_VERSION);
 	}
 
 	ge->Init();
@@ -35,6 +35,7 @@ client_t *sv_client; /* current client */
 cvar_t *sv_paused;
 cvar_t *sv_timedemo;
 cvar_t *sv_enforcetime;
+cvar_t *sv_threads;
 cvar_t *timeout; /* seconds without any message */
 cvar_t *zombietime; /* seconds to sink messages after disconnect */
 cvar_t *rcon_password; /* password for remote server commands */
@@ -81,6 +82,119 @@ SV_DropClient(client_t *drop)
 	drop->name[0] = 0;
 }
 
+/*
+ * Hashes the parts of an address that NET_CompareBaseAdr
+ * looks at together with the qport. The port itself is
+ * left out, it may be changed by address translating
+ * routers while the connection is alive.
+ */
+static unsigned int
+SV_ClientHashKey(netadr_t adr, int qport)
+{
+	unsigned int hash;
+	byte *data;
+	int len;
+	int i;
+
+	switch (adr.type)
+	{
+		case NA_IP:
+			data = adr.ip;
+			len = 4;
+			break;
+		case NA_IP6:
+			data = adr.ip;
+			len = 16;
+			break;
+		case NA_IPX:
+			data = adr.ipx;
+			len = 10;
+			break;
+		default:
+			data = NULL;
+			len = 0;
+			break;
+	}
+
+	hash = 2166136261u ^ adr.type;
+
+	for (i = 0; i < len; i++)
+	{
+		hash = (hash ^ data[i]) * 16777619u;
+	}
+
+	hash = (hash ^ (qport & 0xff)) * 16777619u;
+	hash = (hash ^ ((qport >> 8) & 0xff)) * 16777619u;
+
+	return hash & (CLIENT_HASH_SIZE - 1);
+}
+
+/*
+ * Adds a client to the address hash. Must be
+ * called once the netchan has been set up.
+ */
+void
+SV_HashClient(client_t *cl)
+{
+	unsigned int key;
+
+	key = SV_ClientHashKey(cl->netchan.remote_address, cl->netchan.qport);
+
+	cl->hashnext = svs.client_hash[key];
+	svs.client_hash[key] = cl;
+}
+
+/*
+ * Removes a client from the address hash. Does
+ * nothing if the client isn't hashed.
+ */
+void
+SV_UnhashClient(client_t *cl)
+{
+	client_t **prev;
+	unsigned int key;
+
+	key = SV_ClientHashKey(cl->netchan.remote_address, cl->netchan.qport);
+
+	for (prev = &svs.client_hash[key]; *prev; prev = &(*prev)->hashnext)
+	{
+		if (*prev == cl)
+		{
+			*prev = cl->hashnext;
+			break;
+		}
+	}
+
+	cl->hashnext = NULL;
+}
+
+/*
+ * Returns the non free client with the given
+ * base address and qport, or NULL if there's none.
+ */
+client_t *
+SV_FindClient(netadr_t adr, int qport)
+{
+	client_t *cl;
+
+	svs.clienthash_lookups++;
+
+	for (cl = svs.client_hash[SV_ClientHashKey(adr, qport)]; cl; cl = cl->hashnext)
+	{
+		svs.clienthash_probes++;
+
+		if ((cl->netchan.qport == qport) &&
+			NET_CompareBaseAdr(adr, cl->netchan.remote_address))
+		{
+			return cl;
+		}
+
+		svs.clienthash_collisions++;
+	}
+
+	return NULL;
+}
+
 /*
  * Builds the string that is sent as heartbeats and status replies
  */
@@ -197,7 +311,6 @@ SV_GiveMsec(void)
 void
 SV_ReadPackets(void)
 {
-	int i;
 	client_t *cl;
 	int qport;
 
@@ -218,49 +331,31 @@ SV_ReadPackets(void)
 		qport = MSG_ReadShort(&net_message) & 0xffff;
 
 		/* check for packets from connected clients */
-		for (i = 0, cl = svs.clients; i < maxclients->value; i++, cl++)
-		{
-			if (cl->state == cs_free)
-			{
-				continue;
-			}
+		cl = SV_FindClient(net_from, qport);
 
-			if (!NET_CompareBaseAdr(net_from, cl->netchan.remote_address))
-			{
-				continue;
-			}
+		if (!cl)
+		{
+			continue;
+		}
 
-			if (cl->netchan.qport != qport)
-			{
-				continue;
-			}
+		if (cl->netchan.remote_address.port != net_from.port)
+		{
+			Com_Printf("SV_ReadPackets: fixing up a translated port\n");
+			cl->netchan.remote_address.port = net_from.port;
+		}
 
-			if (cl->netchan.remote_address.port != net_from.port)
+		if (Netchan_Process(&cl->netchan, &net_message))
+		{
+			/* this is a valid, sequenced packet, so process it */
+			if (cl->state != cs_zombie)
 			{
-				Com_Printf("SV_ReadPackets: fixing up a translated port\n");
-				cl->netchan.remote_address.port = net_from.port;
-			}
+				cl->lastmessage = svs.realtime; /* don't timeout */
 
-			if (Netchan_Process(&cl->netchan, &net_message))
-			{
-				/* this is a valid, sequenced packet, so process it */
-				if (cl->state != cs_zombie)
+				if (!(sv.demofile && (sv.state == ss_demo)))
 				{
-					cl->lastmessage = svs.realtime; /* don't timeout */
-
-					if (!(sv.demofile && (sv.state == ss_demo)))
-					{
-						SV_ExecuteClientMessage(cl);
-					}
+					SV_ExecuteClientMessage(cl);
 				}
 			}
-
-			break;
-		}
-
-		if (i != maxclients->value)
-		{
-			continue;
 		}
 	}
 }
@@ -296,6 +391,7 @@ SV_CheckTimeouts(void)
 		if ((cl->state == cs_zombie) &&
 			(cl->lastmessage < zombiepoint))
 		{
+			SV_UnhashClient(cl);
 			cl->state = cs_free; /* can now be reused */
 			continue;
 		}
@@ -305,6 +401,7 @@ SV_CheckTimeouts(void)
 		{
 			SV_BroadcastPrintf(PRINT_HIGH, "%s timed out\n", cl->name);
 			SV_DropClient(cl);
+			SV_UnhashClient(cl);
 			cl->state = cs_free; /* don't bother with zombie state */
 		}
 	}
@@ -413,7 +510,8 @@ SV_Frame(int msec)
 			svs.realtime = sv.time - 100;
 		}
 
-		NET_Sleep(sv.time - svs.realtime);
+		/* the main loop sleeps until the frame
+		   is due, see SV_FrameDelay() */
 		return;
 	}
 
@@ -426,6 +524,9 @@ SV_Frame(int msec)
 	/* let everything in the world think and move */
 	SV_RunGameFrame();
 
+	/* find the clients in the BSP for the next frame's multicasts */
+	SV_UpdateClientVis();
+
 	/* send messages back to the clients that had packets read this frame */
 	SV_SendClientMessages();
 
@@ -439,6 +540,27 @@ SV_Frame(int msec)
 	SV_PrepWorldFrame();
 }
 
+/*
+ * Returns the number of milliseconds until the
+ * next server frame is due or -1 if the server
+ * isn't running.
+ */
+int
+SV_FrameDelay(void)
+{
+	if (!svs.initialized)
+	{
+		return -1;
+	}
+
+	if (sv_timedemo->value || (svs.realtime >= sv.time))
+	{
+		return 0;
+	}
+
+	return sv.time - svs.realtime;
+}
+
 /*
  * Send a message to the master every few minutes to
  * let it know we are alive, and log information
@@ -601,6 +723,7 @@ SV_Init(void)
 	sv_paused = Cvar_Get("paused", "0", 0);
 	sv_timedemo = Cvar_Get("timedemo", "0", 0);
 	sv_enforcetime = Cvar_Get("sv_enforcetime", "0", 0);
+	sv_threads = Cvar_Get("sv_threads", "1", 0);
 	allow_download = Cvar_Get("allow_download", "1", CVAR_ARCHIVE);
 	allow_download_players = Cvar_Get("allow_download_players", "0", CVAR_ARCHIVE);
 	allow_download_models = Cvar_Get("allow_download_models", "1", CVAR_ARCHIVE);
@@ -670,6 +793,11 @@ SV_FinalMessage(char *message, qboolean reconnect)
 void
 SV_Shutdown(char *finalmsg, qboolean reconnect)
 {
+	/* an error may have aborted SV_SendClientMessages
+	   while it was queueing, the final message must
+	   go out right away */
+	NET_FlushPackets(NS_SERVER);
+
 	if (svs.clients)
 	{
 		SV_FinalMessage(finalmsg, reconnect);
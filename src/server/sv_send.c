@@ -138,6 +138,85 @@ SV_BroadcastCommand(char *fmt, ...)
 	SV_Multicast(NULL, MULTICAST_ALL_R);
 }
 
+/*
+ * Returns the cached leaf, cluster and area of the client's
+ * edict, looking them up again if the edict has moved since.
+ */
+clientvis_t *
+SV_ClientVis(client_t *cl)
+{
+	clientvis_t *vis;
+	float *org;
+
+	vis = &cl->vis;
+	org = cl->edict->s.origin;
+
+	if (vis->valid && (vis->spawncount == svs.spawncount) &&
+		VectorCompare(org, vis->origin))
+	{
+		return vis;
+	}
+
+	VectorCopy(org, vis->origin);
+	vis->leafnum = CM_PointLeafnum(org);
+	vis->cluster = CM_LeafCluster(vis->leafnum);
+	vis->area = CM_LeafArea(vis->leafnum);
+	vis->spawncount = svs.spawncount;
+	vis->valid = true;
+
+	return vis;
+}
+
+/*
+ * Called after the game frame, so that the multicasts
+ * of the next one mostly find the clients already cached.
+ */
+void
+SV_UpdateClientVis(void)
+{
+	client_t *cl;
+	int i;
+
+	for (i = 0, cl = svs.clients; i < maxclients->value; i++, cl++)
+	{
+		if (cl->state == cs_spawned)
+		{
+			SV_ClientVis(cl);
+		}
+	}
+}
+
+/*
+ * Finds cluster and area of a point. The game mostly passes
+ * ent->s.origin, if that belongs to a client the cache is used.
+ */
+void
+SV_PointVis(vec3_t p, int *cluster, int *area)
+{
+	clientvis_t *vis;
+	byte *first;
+	int leafnum, n;
+
+	first = (byte *)EDICT_NUM(1);
+
+	if ((byte *)p >= first)
+	{
+		n = ((byte *)p - first) / ge->edict_size;
+
+		if ((n < maxclients->value) && (p == EDICT_NUM(n + 1)->s.origin))
+		{
+			vis = SV_ClientVis(svs.clients + n);
+			*cluster = vis->cluster;
+			*area = vis->area;
+			return;
+		}
+	}
+
+	leafnum = CM_PointLeafnum(p);
+	*cluster = CM_LeafCluster(leafnum);
+	*area = CM_LeafArea(leafnum);
+}
+
 /*
  * Sends the contents of sv.multicast to a subset of the clients,
  * then clears sv.multicast.
@@ -150,21 +229,22 @@ void
 SV_Multicast(vec3_t origin, multicast_t to)
 {
 	client_t *client;
+	clientvis_t *vis;
 	byte *mask;
-	int leafnum = 0, cluster;
+	int cluster;
 	int j;
 	qboolean reliable;
-	int area1, area2;
+	int area1;
 
 	reliable = false;
 
 	if ((to != MULTICAST_ALL_R) && (to != MULTICAST_ALL))
 	{
-		leafnum = CM_PointLeafnum(origin);
-		area1 = CM_LeafArea(leafnum);
+		SV_PointVis(origin, &cluster, &area1);
 	}
 	else
 	{
+		cluster = -1;
 		area1 = 0;
 	}
 
@@ -185,16 +265,12 @@ SV_Multicast(vec3_t origin, multicast_t to)
 		case MULTICAST_PHS_R:
 			reliable = true; /* intentional fallthrough */
 		case MULTICAST_PHS:
-			leafnum = CM_PointLeafnum(origin);
-			cluster = CM_LeafCluster(leafnum);
 			mask = CM_ClusterPHS(cluster);
 			break;
 
 		case MULTICAST_PVS_R:
 			reliable = true; /* intentional fallthrough */
 		case MULTICAST_PVS:
-			leafnum = CM_PointLeafnum(origin);
-			cluster = CM_LeafCluster(leafnum);
 			mask = CM_ClusterPVS(cluster);
 			break;
 
@@ -218,16 +294,14 @@ SV_Multicast(vec3_t origin, multicast_t to)
 
 		if (mask)
 		{
-			leafnum = CM_PointLeafnum(client->edict->s.origin);
-			cluster = CM_LeafCluster(leafnum);
-			area2 = CM_LeafArea(leafnum);
+			vis = SV_ClientVis(client);
 
-			if (!CM_AreasConnected(area1, area2))
+			if (!(mask[vis->cluster >> 3] & (1 << (vis->cluster & 7))))
 			{
 				continue;
 			}
 
-			if (mask && (!(mask[cluster >> 3] & (1 << (cluster & 7)))))
+			if (!CM_AreasConnected(area1, vis->area))
 			{
 				continue;
 			}
@@ -351,7 +425,8 @@ SV_StartSound(vec3_t origin, edict_t *entity, int channel, int soundindex,
 		}
 		else
 		{
-			VectorCopy(entity->s.origin, origin_v);
+			/* lets SV_Multicast() find a client's cached leaf */
+			origin = entity->s.origin;
 		}
 	}
 
@@ -415,21 +490,13 @@ SV_StartSound(vec3_t origin, edict_t *entity, int channel, int soundindex,
 	}
 }
 
-qboolean
-SV_SendClientDatagram(client_t *client)
+/*
+ * Appends the multicast datagram to a message
+ * holding the client's frame and sends it
+ */
+static void
+SV_TransmitClientDatagram(client_t *client, sizebuf_t *msg)
 {
-	byte msg_buf[MAX_MSGLEN];
-	sizebuf_t msg;
-
-	SV_BuildClientFrame(client);
-
-	SZ_Init(&msg, msg_buf, sizeof(msg_buf));
-	msg.allowoverflow = true;
-
-	/* send over all the relevant entity_state_t
-	   and the player_state_t */
-	SV_WriteFrameToClient(client, &msg);
-
 	/* copy the accumulated multicast datagram
 	   for this client out to the message
 	   it is necessary for this to be after the WriteEntities
@@ -440,23 +507,41 @@ SV_SendClientDatagram(client_t *client)
 	}
 	else
 	{
-		SZ_Write(&msg, client->datagram.data, client->datagram.cursize);
+		SZ_Write(msg, client->datagram.data, client->datagram.cursize);
 	}
 
 	SZ_Clear(&client->datagram);
 
-	if (msg.overflowed)
+	if (msg->overflowed)
 	{
 		/* must have room left for the packet header */
 		Com_Printf("WARNING: msg overflowed for %s\n", client->name);
-		SZ_Clear(&msg);
+		SZ_Clear(msg);
 	}
 
 	/* send the datagram */
-	Netchan_Transmit(&client->netchan, msg.cursize, msg.data);
+	Netchan_Transmit(&client->netchan, msg->cursize, msg->data);
 
 	/* record the size for rate estimation */
-	client->message_size[sv.framenum % RATE_MESSAGES] = msg.cursize;
+	client->message_size[sv.framenum % RATE_MESSAGES] = msg->cursize;
+}
+
+qboolean
+SV_SendClientDatagram(client_t *client)
+{
+	byte msg_buf[MAX_MSGLEN];
+	sizebuf_t msg;
+
+	SV_BuildClientFrame(client);
+
+	SZ_Init(&msg, msg_buf, sizeof(msg_buf));
+	msg.allowoverflow = true;
+
+	/* send over all the relevant entity_state_t
+	   and the player_state_t */
+	SV_WriteFrameToClient(client, &msg);
+
+	SV_TransmitClientDatagram(client, &msg);
 
 	return true;
 }
@@ -506,6 +591,69 @@ SV_RateDrop(client_t *c)
 	return false;
 }
 
+/*
+ * Sends the frames of all spawned clients like the loop
+ * in SV_SendClientMessages() does, but they're built at
+ * once by SV_BuildClientMessages() and may use several
+ * threads. Must not be used if a client overflowed,
+ * dropping it would change the world between frames.
+ */
+static void
+SV_SendClientDatagrams(void)
+{
+	static client_t *clients[MAX_CLIENTS];
+	static sizebuf_t msgs[MAX_CLIENTS];
+	static byte msg_bufs[MAX_CLIENTS][MAX_MSGLEN];
+	qboolean send[MAX_CLIENTS];
+	client_t *c;
+	int count;
+	int i;
+
+	count = 0;
+
+	for (i = 0, c = svs.clients; i < maxclients->value; i++, c++)
+	{
+		/* don't overrun bandwidth */
+		send[i] = (c->state == cs_spawned) && !SV_RateDrop(c);
+
+		if (send[i])
+		{
+			SZ_Init(&msgs[count], msg_bufs[count], sizeof(msg_bufs[count]));
+			msgs[count].allowoverflow = true;
+
+			/* written by worker threads, which mustn't
+			   print. SV_TransmitClientDatagram warns. */
+			msgs[count].quietoverflow = true;
+			clients[count++] = c;
+		}
+	}
+
+	/* send over all the relevant entity_state_t
+	   and the player_state_t */
+	SV_BuildClientMessages(clients, msgs, count);
+
+	/* transmit in the same order as
+	   SV_SendClientMessages() does */
+	count = 0;
+
+	for (i = 0, c = svs.clients; i < maxclients->value; i++, c++)
+	{
+		if (send[i])
+		{
+			SV_TransmitClientDatagram(c, &msgs[count++]);
+		}
+		else if ((c->state == cs_connected) || (c->state == cs_zombie))
+		{
+			/* just update reliable	if needed */
+			if (c->netchan.message.cursize ||
+				(curtime - c->netchan.last_sent > 1000))
+			{
+				Netchan_Transmit(&c->netchan, 0, NULL);
+			}
+		}
+	}
+}
+
 void
 SV_SendClientMessages(void)
 {
@@ -559,6 +707,31 @@ SV_SendClientMessages(void)
 		}
 	}
 
+	/* collect all datagrams of this frame
+	   and send them in as few syscalls as
+	   possible */
+	NET_QueuePackets(NS_SERVER);
+
+	/* build the frames in parallel unless
+	   a client needs to be dropped */
+	if ((sv_threads->value > 1) && (sv.state == ss_game))
+	{
+		for (i = 0, c = svs.clients; i < maxclients->value; i++, c++)
+		{
+			if (c->state && c->netchan.message.overflowed)
+			{
+				break;
+			}
+		}
+
+		if (i == maxclients->value)
+		{
+			SV_SendClientDatagrams();
+			NET_FlushPackets(NS_SERVER);
+			return;
+		}
+	}
+
 	/* send a message to each connected client */
 	for (i = 0, c = svs.clients; i < maxclients->value; i++, c++)
 	{
@@ -604,5 +777,7 @@ SV_SendClientMessages(void)
 			}
 		}
 	}
+
+	NET_FlushPackets(NS_SERVER);
 }
 
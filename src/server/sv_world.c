@@ -26,30 +26,70 @@
 
 #include "header/server.h"
 
-#define AREA_DEPTH 4
-#define AREA_NODES 32
+#define AREA_MAXNODES 4096
+#define AREA_MAXDEPTH 8
+#define AREA_MINSIZE 64 /* smallest half size of a node */
+#define AREA_SPLIT 8 /* edicts in a node before it gets children */
 #define MAX_TOTAL_ENT_LEAFS 128
 
 #define STRUCT_FROM_LINK(l, t, m) ((t *)((byte *)l - (byte *)&(((t *)NULL)->m)))
 #define EDICT_FROM_AREA(l) STRUCT_FROM_LINK(l, edict_t, area)
 
+/*
+ * The edicts are sorted into a loose octree. Every node is a cube,
+ * an edict goes into the smallest one whose cube holds its center
+ * and that is at least as large as the edict. The node's bounds are
+ * doubled, so they always enclose its edicts and nothing straddles.
+ * Nodes are only created where they'll hold something, and a node
+ * only gets children once it holds more than AREA_SPLIT edicts, so
+ * crowded regions get deep trees and empty ones cost nothing.
+ */
 typedef struct areanode_s
 {
-	int axis; /* -1 = leaf node */
-	float dist;
-	struct areanode_s *children[2];
+	vec3_t center;
+	float size; /* half the edge of the cube */
+	int depth;
+	qboolean split; /* edicts may go into children */
+	struct areanode_s *parent;
+	struct areanode_s *children[8];
+	int numedicts; /* in this node */
+	int total[2]; /* solids and triggers in this subtree */
 	link_t trigger_edicts;
 	link_t solid_edicts;
 } areanode_t;
 
-areanode_t sv_areanodes[AREA_NODES];
+areanode_t sv_areanodes[AREA_MAXNODES];
 int sv_numareanodes;
+int sv_areadepth; /* the deepest level allowed for this map */
+
+/* where every linked edict is, the solid type
+   may have changed by the time it's unlinked.
+   absmin and absmax are the box the clusters
+   and areas in the edict were last set for. */
+typedef struct
+{
+	areanode_t *node;
+	int trigger;
+	qboolean classified;
+	vec3_t absmin, absmax;
+} arealink_t;
+
+arealink_t sv_arealinks[MAX_EDICTS];
 
 float *area_mins, *area_maxs;
 edict_t **area_list;
 int area_count, area_maxcount;
 int area_type;
 
+/* statistics */
+int area_queries;
+int area_nodesvisited;
+int area_edictstested;
+int area_found;
+int area_links;
+int area_reclassified;
+int area_moved;
+
 int SV_HullForEntity(edict_t *ent);
 
 /* ClearLink is used for new headnodes */
@@ -75,65 +115,264 @@ InsertLinkBefore(link_t *l, link_t *before)
 	l->next->prev = l;
 }
 
-/*
- * Builds a uniformly subdivided tree for the given world size
- */
-areanode_t *
-SV_CreateAreaNode(int depth, vec3_t mins, vec3_t maxs)
+static areanode_t *
+SV_AllocAreaNode(areanode_t *parent, int octant)
 {
 	areanode_t *anode;
-	vec3_t size;
-	vec3_t mins1, maxs1, mins2, maxs2;
+	int i;
+
+	if (sv_numareanodes == AREA_MAXNODES)
+	{
+		return NULL;
+	}
 
 	anode = &sv_areanodes[sv_numareanodes];
 	sv_numareanodes++;
 
+	memset(anode, 0, sizeof(*anode));
 	ClearLink(&anode->trigger_edicts);
 	ClearLink(&anode->solid_edicts);
 
-	if (depth == AREA_DEPTH)
+	if (parent)
+	{
+		anode->parent = parent;
+		anode->depth = parent->depth + 1;
+		anode->size = parent->size * 0.5f;
+
+		for (i = 0; i < 3; i++)
+		{
+			anode->center[i] = parent->center[i] +
+				((octant & (1 << i)) ? anode->size : -anode->size);
+		}
+
+		parent->children[octant] = anode;
+	}
+
+	return anode;
+}
+
+/*
+ * The root is a cube around the world. How deep the tree may
+ * go depends on the size of the world, nodes are never smaller
+ * than AREA_MINSIZE.
+ */
+void
+SV_ClearWorld(void)
+{
+	areanode_t *root;
+	float *mins, *maxs;
+	float size;
+	int i;
+
+	memset(sv_arealinks, 0, sizeof(sv_arealinks));
+	sv_numareanodes = 0;
+
+	root = SV_AllocAreaNode(NULL, 0);
+
+	mins = sv.models[1]->mins;
+	maxs = sv.models[1]->maxs;
+
+	for (i = 0; i < 3; i++)
+	{
+		root->center[i] = 0.5f * (mins[i] + maxs[i]);
+		size = 0.5f * (maxs[i] - mins[i]);
+
+		if (size > root->size)
+		{
+			root->size = size;
+		}
+	}
+
+	root->size += 1;
+
+	for (sv_areadepth = 0; sv_areadepth < AREA_MAXDEPTH; sv_areadepth++)
+	{
+		if (root->size / (2 << sv_areadepth) < AREA_MINSIZE)
+		{
+			break;
+		}
+	}
+}
+
+static float
+SV_AreaBounds(edict_t *ent, vec3_t center)
+{
+	float radius, r;
+	int i;
+
+	radius = 0;
+
+	for (i = 0; i < 3; i++)
+	{
+		center[i] = 0.5f * (ent->absmin[i] + ent->absmax[i]);
+		r = 0.5f * (ent->absmax[i] - ent->absmin[i]);
+
+		if (r > radius)
+		{
+			radius = r;
+		}
+	}
+
+	return radius;
+}
+
+/*
+ * Puts the edict into the lowest fitting node
+ * below start, creating nodes as needed.
+ */
+static void
+SV_AreaInsert(edict_t *ent, areanode_t *node)
+{
+	vec3_t center;
+	float radius;
+	int i, octant, trigger, num;
+	edict_t *crowd[AREA_SPLIT + 1];
+	areanode_t *child;
+	arealink_t *alink;
+	link_t *l;
+
+	radius = SV_AreaBounds(ent, center);
+
+	while (node->split && (radius <= node->size * 0.5f))
 	{
-		anode->axis = -1;
-		anode->children[0] = anode->children[1] = NULL;
-		return anode;
+		octant = 0;
+
+		for (i = 0; i < 3; i++)
+		{
+			/* outside the world, leave it in the root */
+			if (fabs(center[i] - node->center[i]) > node->size)
+			{
+				break;
+			}
+
+			if (center[i] >= node->center[i])
+			{
+				octant |= 1 << i;
+			}
+		}
+
+		if (i < 3)
+		{
+			break;
+		}
+
+		child = node->children[octant];
+
+		if (!child)
+		{
+			child = SV_AllocAreaNode(node, octant);
+
+			if (!child)
+			{
+				break; /* out of nodes, good enough */
+			}
+		}
+
+		node = child;
 	}
 
-	VectorSubtract(maxs, mins, size);
+	/* link it in */
+	trigger = (ent->solid == SOLID_TRIGGER);
 
-	if (size[0] > size[1])
+	if (trigger)
 	{
-		anode->axis = 0;
+		InsertLinkBefore(&ent->area, &node->trigger_edicts);
 	}
 	else
 	{
-		anode->axis = 1;
+		InsertLinkBefore(&ent->area, &node->solid_edicts);
 	}
 
-	anode->dist = 0.5f * (maxs[anode->axis] + mins[anode->axis]);
-	VectorCopy(mins, mins1);
-	VectorCopy(mins, mins2);
-	VectorCopy(maxs, maxs1);
-	VectorCopy(maxs, maxs2);
+	alink = &sv_arealinks[NUM_FOR_EDICT(ent)];
+	alink->node = node;
+	alink->trigger = trigger;
 
-	maxs1[anode->axis] = mins2[anode->axis] = anode->dist;
+	node->numedicts++;
 
-	anode->children[0] = SV_CreateAreaNode(depth + 1, mins2, maxs2);
-	anode->children[1] = SV_CreateAreaNode(depth + 1, mins1, maxs1);
+	for (child = node; child; child = child->parent)
+	{
+		child->total[trigger]++;
+	}
 
-	return anode;
+	if (node->split || (node->numedicts <= AREA_SPLIT) ||
+		(node->depth >= sv_areadepth))
+	{
+		return;
+	}
+
+	/* crowded, push down whatever fits into a child.
+	   Nodes split at AREA_SPLIT + 1, that's all there is. */
+	node->split = true;
+	num = 0;
+
+	for (l = node->solid_edicts.next; l != &node->solid_edicts; l = l->next)
+	{
+		crowd[num++] = EDICT_FROM_AREA(l);
+	}
+
+	for (l = node->trigger_edicts.next; l != &node->trigger_edicts; l = l->next)
+	{
+		crowd[num++] = EDICT_FROM_AREA(l);
+	}
+
+	for (i = 0; i < num; i++)
+	{
+		SV_UnlinkEdict(crowd[i]);
+		SV_AreaInsert(crowd[i], node);
+	}
 }
 
-void
-SV_ClearWorld(void)
+/*
+ * True if SV_AreaInsert would put the linked
+ * edict back into the node it's already in.
+ */
+static qboolean
+SV_AreaFits(edict_t *ent, arealink_t *alink)
 {
-	memset(sv_areanodes, 0, sizeof(sv_areanodes));
-	sv_numareanodes = 0;
-	SV_CreateAreaNode(0, sv.models[1]->mins, sv.models[1]->maxs);
+	vec3_t center;
+	float radius;
+	areanode_t *node;
+	qboolean inside;
+	int i;
+
+	if (alink->trigger != (ent->solid == SOLID_TRIGGER))
+	{
+		return false;
+	}
+
+	node = alink->node;
+	radius = SV_AreaBounds(ent, center);
+	inside = true;
+
+	for (i = 0; i < 3; i++)
+	{
+		if (fabs(center[i] - node->center[i]) > node->size)
+		{
+			inside = false;
+		}
+	}
+
+	/* moved out of the node, only the root takes everything */
+	if (node->parent && (!inside || (radius > node->size)))
+	{
+		return false;
+	}
+
+	/* shrunk or moved into the world, it'd go deeper */
+	if (inside && node->split && (radius <= node->size * 0.5f))
+	{
+		return false;
+	}
+
+	return true;
 }
 
 void
 SV_UnlinkEdict(edict_t *ent)
 {
+	arealink_t *alink;
+	areanode_t *node;
+
 	if (!ent->area.prev)
 	{
 		return; /* not linked in anywhere */
@@ -141,31 +380,39 @@ SV_UnlinkEdict(edict_t *ent)
 
 	RemoveLink(&ent->area);
 	ent->area.prev = ent->area.next = NULL;
+
+	alink = &sv_arealinks[NUM_FOR_EDICT(ent)];
+	node = alink->node;
+	alink->node = NULL;
+
+	node->numedicts--;
+
+	for ( ; node; node = node->parent)
+	{
+		node->total[alink->trigger]--;
+	}
 }
 
 void
 SV_LinkEdict(edict_t *ent)
 {
-	areanode_t *node;
 	int leafs[MAX_TOTAL_ENT_LEAFS];
 	int clusters[MAX_TOTAL_ENT_LEAFS];
 	int num_leafs;
 	int i, j, k;
 	int area;
 	int topnode;
-
-	if (ent->area.prev)
-	{
-		SV_UnlinkEdict(ent); /* unlink from old position */
-	}
+	arealink_t *alink;
 
 	if (ent == ge->edicts)
 	{
+		SV_UnlinkEdict(ent);
 		return; /* don't add the world */
 	}
 
 	if (!ent->inuse)
 	{
+		SV_UnlinkEdict(ent);
 		return;
 	}
 
@@ -275,6 +522,26 @@ SV_LinkEdict(edict_t *ent)
 	ent->absmax[1] += 1;
 	ent->absmax[2] += 1;
 
+	area_links++;
+	alink = &sv_arealinks[NUM_FOR_EDICT(ent)];
+
+	/* the game relinks most edicts every frame without
+	   moving them. The clusters and areas depend on
+	   nothing but the abs box, keep them if it's the
+	   same. A zero linkcount means the game cleared
+	   the edict, so they're gone. */
+	if (ent->linkcount && alink->classified &&
+		VectorCompare(ent->absmin, alink->absmin) &&
+		VectorCompare(ent->absmax, alink->absmax))
+	{
+		goto classified;
+	}
+
+	area_reclassified++;
+	alink->classified = true;
+	VectorCopy(ent->absmin, alink->absmin);
+	VectorCopy(ent->absmax, alink->absmax);
+
 	/* link to PVS leafs */
 	ent->num_clusters = 0;
 	ent->areanum = 0;
@@ -352,6 +619,8 @@ SV_LinkEdict(edict_t *ent)
 		}
 	}
 
+classified:
+
 	/* if first time, make sure old_origin is valid */
 	if (!ent->linkcount)
 	{
@@ -362,42 +631,20 @@ SV_LinkEdict(edict_t *ent)
 
 	if (ent->solid == SOLID_NOT)
 	{
+		SV_UnlinkEdict(ent);
 		return;
 	}
 
-	/* find the first node that the ent's box crosses */
-	node = sv_areanodes;
-
-	while (1)
+	/* still in the right node, the position in
+	   its list doesn't matter */
+	if (ent->area.prev && SV_AreaFits(ent, alink))
 	{
-		if (node->axis == -1)
-		{
-			break;
-		}
-
-		if (ent->absmin[node->axis] > node->dist)
-		{
-			node = node->children[0];
-		}
-		else if (ent->absmax[node->axis] < node->dist)
-		{
-			node = node->children[1];
-		}
-		else
-		{
-			break; /* crosses the node */
-		}
+		return;
 	}
 
-	/* link it in */
-	if (ent->solid == SOLID_TRIGGER)
-	{
-		InsertLinkBefore(&ent->area, &node->trigger_edicts);
-	}
-	else
-	{
-		InsertLinkBefore(&ent->area, &node->solid_edicts);
-	}
+	area_moved++;
+	SV_UnlinkEdict(ent);
+	SV_AreaInsert(ent, sv_areanodes);
 }
 
 void
@@ -405,6 +652,11 @@ SV_AreaEdicts_r(areanode_t *node)
 {
 	link_t *l, *next, *start;
 	edict_t *check;
+	areanode_t *child;
+	float size;
+	int i, j;
+
+	area_nodesvisited++;
 
 	/* touch linked edicts */
 	if (area_type == AREA_SOLID)
@@ -426,6 +678,8 @@ SV_AreaEdicts_r(areanode_t *node)
 			continue; /* deactivated */
 		}
 
+		area_edictstested++;
+
 		if ((check->absmin[0] > area_maxs[0]) ||
 			(check->absmin[1] > area_maxs[1]) ||
 			(check->absmin[2] > area_maxs[2]) ||
@@ -446,20 +700,32 @@ SV_AreaEdicts_r(areanode_t *node)
 		area_count++;
 	}
 
-	if (node->axis == -1)
+	/* recurse into the children whose loose
+	   bounds touch the box and hold something */
+	for (i = 0; i < 8; i++)
 	{
-		return; /* terminal node */
-	}
+		child = node->children[i];
 
-	/* recurse down both sides */
-	if (area_maxs[node->axis] > node->dist)
-	{
-		SV_AreaEdicts_r(node->children[0]);
-	}
+		if (!child || !child->total[area_type != AREA_SOLID])
+		{
+			continue;
+		}
 
-	if (area_mins[node->axis] < node->dist)
-	{
-		SV_AreaEdicts_r(node->children[1]);
+		size = child->size * 2;
+
+		for (j = 0; j < 3; j++)
+		{
+			if ((area_mins[j] > child->center[j] + size) ||
+				(area_maxs[j] < child->center[j] - size))
+			{
+				break;
+			}
+		}
+
+		if (j == 3)
+		{
+			SV_AreaEdicts_r(child);
+		}
 	}
 }
 
@@ -474,8 +740,12 @@ SV_AreaEdicts(vec3_t mins, vec3_t maxs, edict_t **list,
 	area_type = areatype;
 	area_count = 0;
 
+	area_queries++;
+
 	SV_AreaEdicts_r(sv_areanodes);
 
+	area_found += area_count;
+
 	area_mins = 0;
 	area_maxs = 0;
 	area_list = 0;
@@ -485,6 +755,76 @@ SV_AreaEdicts(vec3_t mins, vec3_t maxs, edict_t **list,
 	return area_count;
 }
 
+/*
+ * Prints how the edicts are spread over the
+ * tree and what queries cost since the last call
+ */
+void
+SV_AreaStats_f(void)
+{
+	int nodes[AREA_MAXDEPTH + 1], edicts[AREA_MAXDEPTH + 1];
+	int i, maxedicts, numsplit;
+	areanode_t *node;
+
+	if (!sv_numareanodes)
+	{
+		Com_Printf("No map running.\n");
+		return;
+	}
+
+	memset(nodes, 0, sizeof(nodes));
+	memset(edicts, 0, sizeof(edicts));
+	maxedicts = numsplit = 0;
+
+	for (i = 0, node = sv_areanodes; i < sv_numareanodes; i++, node++)
+	{
+		nodes[node->depth]++;
+		edicts[node->depth] += node->numedicts;
+
+		if (node->numedicts > maxedicts)
+		{
+			maxedicts = node->numedicts;
+		}
+
+		if (node->split)
+		{
+			numsplit++;
+		}
+	}
+
+	Com_Printf("%i of %i nodes, %i split, root size %.0f, depth %i\n",
+			sv_numareanodes, AREA_MAXNODES, numsplit,
+			sv_areanodes[0].size * 2, sv_areadepth);
+	Com_Printf("%i solid and %i trigger edicts, at most %i in a node\n",
+			sv_areanodes[0].total[0], sv_areanodes[0].total[1], maxedicts);
+
+	for (i = 0; i <= sv_areadepth; i++)
+	{
+		if (nodes[i])
+		{
+			Com_Printf("  depth %i: %4i nodes of %6.0f, %4i edicts\n", i,
+					nodes[i], sv_areanodes[0].size * 2 / (1 << i), edicts[i]);
+		}
+	}
+
+	if (area_queries)
+	{
+		Com_Printf("%i queries: %.1f nodes, %.1f edicts tested, %.1f found\n",
+				area_queries, (float)area_nodesvisited / area_queries,
+				(float)area_edictstested / area_queries,
+				(float)area_found / area_queries);
+	}
+
+	if (area_links)
+	{
+		Com_Printf("%i links: %i reclassified, %i moved in the tree\n",
+				area_links, area_reclassified, area_moved);
+	}
+
+	area_queries = area_nodesvisited = area_edictstested = area_found = 0;
+	area_links = area_reclassified = area_moved = 0;
+}
+
 int
 SV_PointContents(vec3_t p)
 {
@@ -554,99 +894,122 @@ SV_HullForEntity(edict_t *ent)
 	return CM_HeadnodeForBox(ent->mins, ent->maxs);
 }
 
-void
-SV_ClipMoveToEntities(moveclip_t *clip)
+/*
+ * Returns true if the move never collides with touch
+ */
+static qboolean
+SV_ClipIgnore(moveclip_t *clip, edict_t *touch)
 {
-	int i, num;
-	edict_t *touchlist[MAX_EDICTS], *touch;
-	trace_t trace;
-	int headnode;
-	float *angles;
-
-	num = SV_AreaEdicts(clip->boxmins, clip->boxmaxs, touchlist,
-			MAX_EDICTS, AREA_SOLID);
+	if (touch->solid == SOLID_NOT)
+	{
+		return true;
+	}
 
-	/* be careful, it is possible to have an entity in this
-	   list removed before we get to it (killtriggered) */
-	for (i = 0; i < num; i++)
+	if (touch == clip->passedict)
 	{
-		touch = touchlist[i];
+		return true;
+	}
 
-		if (touch->solid == SOLID_NOT)
+	if (clip->passedict)
+	{
+		if (touch->owner == clip->passedict)
 		{
-			continue;
+			return true; /* don't clip against own missiles */
 		}
 
-		if (touch == clip->passedict)
+		if (clip->passedict->owner == touch)
 		{
-			continue;
+			return true; /* don't clip against owner */
 		}
+	}
 
-		if (clip->trace.allsolid)
-		{
-			return;
-		}
+	if (!(clip->contentmask & CONTENTS_DEADMONSTER) &&
+		(touch->svflags & SVF_DEADMONSTER))
+	{
+		return true;
+	}
 
-		if (clip->passedict)
-		{
-			if (touch->owner == clip->passedict)
-			{
-				continue; /* don't clip against own missiles */
-			}
+	return false;
+}
 
-			if (clip->passedict->owner == touch)
-			{
-				continue; /* don't clip against owner */
-			}
-		}
+/*
+ * Clips the move against a single entity, headnode
+ * is the hull returned by SV_HullForEntity()
+ */
+static void
+SV_ClipToEntity(moveclip_t *clip, edict_t *touch, int headnode)
+{
+	trace_t trace;
+	float *angles;
 
-		if (!(clip->contentmask & CONTENTS_DEADMONSTER) &&
-			(touch->svflags & SVF_DEADMONSTER))
-		{
-			continue;
-		}
+	angles = touch->s.angles;
 
-		/* might intersect, so do an exact clip */
-		headnode = SV_HullForEntity(touch);
-		angles = touch->s.angles;
+	if (touch->solid != SOLID_BSP)
+	{
+		angles = vec3_origin; /* boxes don't rotate */
+	}
 
-		if (touch->solid != SOLID_BSP)
-		{
-			angles = vec3_origin; /* boxes don't rotate */
-		}
+	if (touch->svflags & SVF_MONSTER)
+	{
+		trace = CM_TransformedBoxTrace(clip->start, clip->end,
+				clip->mins2, clip->maxs2, headnode, clip->contentmask,
+				touch->s.origin, angles);
+	}
+	else
+	{
+		trace = CM_TransformedBoxTrace(clip->start, clip->end,
+				clip->mins, clip->maxs, headnode, clip->contentmask,
+				touch->s.origin, angles);
+	}
 
-		if (touch->svflags & SVF_MONSTER)
+	if (trace.allsolid || trace.startsolid ||
+		(trace.fraction < clip->trace.fraction))
+	{
+		trace.ent = touch;
+
+		if (clip->trace.startsolid)
 		{
-			trace = CM_TransformedBoxTrace(clip->start, clip->end,
-					clip->mins2, clip->maxs2, headnode, clip->contentmask,
-					touch->s.origin, angles);
+			clip->trace = trace;
+			clip->trace.startsolid = true;
 		}
 		else
 		{
-			trace = CM_TransformedBoxTrace(clip->start, clip->end,
-					clip->mins, clip->maxs, headnode, clip->contentmask,
-					touch->s.origin, angles);
+			clip->trace = trace;
 		}
+	}
+	else if (trace.startsolid)
+	{
+		clip->trace.startsolid = true;
+	}
+}
 
-		if (trace.allsolid || trace.startsolid ||
-			(trace.fraction < clip->trace.fraction))
-		{
-			trace.ent = touch;
+void
+SV_ClipMoveToEntities(moveclip_t *clip)
+{
+	int i, num;
+	edict_t *touchlist[MAX_EDICTS], *touch;
 
-			if (clip->trace.startsolid)
-			{
-				clip->trace = trace;
-				clip->trace.startsolid = true;
-			}
-			else
-			{
-				clip->trace = trace;
-			}
+	num = SV_AreaEdicts(clip->boxmins, clip->boxmaxs, touchlist,
+			MAX_EDICTS, AREA_SOLID);
+
+	/* be careful, it is possible to have an entity in this
+	   list removed before we get to it (killtriggered) */
+	for (i = 0; i < num; i++)
+	{
+		touch = touchlist[i];
+
+		if (clip->trace.allsolid)
+		{
+			return;
 		}
-		else if (trace.startsolid)
+
+		if (SV_ClipIgnore(clip, touch))
 		{
-			clip->trace.startsolid = true;
+			continue;
 		}
+
+		/* might intersect, so do an exact clip */
+		SV_ClipToEntity(clip, touch, SV_HullForEntity(touch));
 	}
 }
 
@@ -722,3 +1085,145 @@ SV_Trace(vec3_t start, vec3_t mins, vec3_t maxs, vec3_t end,
 	return clip.trace;
 }
 
+/*
+ * Traces count rays that share size, passedict and contentmask.
+ * The entities near all of them are gathered once and each hull
+ * is built once, then every ray is clipped against the entities
+ * its own bounds touch. The results match count calls to
+ * SV_Trace(), entities are visited in the same order.
+ */
+void
+SV_MultiTrace(int count, vec3_t *starts, vec3_t *ends, vec3_t mins,
+		vec3_t maxs, edict_t *passedict, int contentmask, trace_t *results)
+{
+	moveclip_t clips[MAX_MULTITRACE], *clip;
+	qboolean blocked[MAX_MULTITRACE];
+	edict_t *touchlist[MAX_EDICTS], *touch;
+	vec3_t boxmins, boxmaxs;
+	int i, j, k, n, num;
+	int active, headnode;
+
+	if (!mins)
+	{
+		mins = vec3_origin;
+	}
+
+	if (!maxs)
+	{
+		maxs = vec3_origin;
+	}
+
+	for (i = 0; i < count; i += n)
+	{
+		n = count - i;
+
+		if (n > MAX_MULTITRACE)
+		{
+			n = MAX_MULTITRACE;
+		}
+
+		active = 0;
+
+		/* clip to world */
+		for (j = 0; j < n; j++)
+		{
+			clip = &clips[j];
+			memset(clip, 0, sizeof(moveclip_t));
+
+			clip->contentmask = contentmask;
+			clip->passedict = passedict;
+
+			clip->trace = CM_BoxTrace(starts[i + j], ends[i + j],
+					mins, maxs, 0, contentmask);
+			clip->trace.ent = ge->edicts;
+
+			blocked[j] = (clip->trace.fraction == 0);
+
+			if (blocked[j])
+			{
+				continue; /* blocked by the world */
+			}
+
+			clip->start = starts[i + j];
+			clip->end = ends[i + j];
+			clip->mins = mins;
+			clip->maxs = maxs;
+
+			VectorCopy(mins, clip->mins2);
+			VectorCopy(maxs, clip->maxs2);
+
+			SV_TraceBounds(clip->start, clip->mins2, clip->maxs2,
+					clip->end, clip->boxmins, clip->boxmaxs);
+
+			if (!active)
+			{
+				VectorCopy(clip->boxmins, boxmins);
+				VectorCopy(clip->boxmaxs, boxmaxs);
+			}
+			else
+			{
+				AddPointToBounds(clip->boxmins, boxmins, boxmaxs);
+				AddPointToBounds(clip->boxmaxs, boxmins, boxmaxs);
+			}
+
+			active++;
+		}
+
+		/* clip to other solid entities */
+		num = 0;
+
+		if (active)
+		{
+			num = SV_AreaEdicts(boxmins, boxmaxs, touchlist,
+					MAX_EDICTS, AREA_SOLID);
+		}
+
+		for (k = 0; k < num; k++)
+		{
+			touch = touchlist[k];
+
+			/* the filters only depend on passedict
+			   and contentmask, same for all rays */
+			if (SV_ClipIgnore(&clips[0], touch))
+			{
+				continue;
+			}
+
+			headnode = -1;
+
+			for (j = 0; j < n; j++)
+			{
+				clip = &clips[j];
+
+				if (blocked[j] || clip->trace.allsolid)
+				{
+					continue;
+				}
+
+				/* the test SV_AreaEdicts() would have
+				   done with the bounds of this ray */
+				if ((touch->absmin[0] > clip->boxmaxs[0]) ||
+					(touch->absmin[1] > clip->boxmaxs[1]) ||
+					(touch->absmin[2] > clip->boxmaxs[2]) ||
+					(touch->absmax[0] < clip->boxmins[0]) ||
+					(touch->absmax[1] < clip->boxmins[1]) ||
+					(touch->absmax[2] < clip->boxmins[2]))
+				{
+					continue;
+				}
+
+				if (headnode == -1)
+				{
+					headnode = SV_HullForEntity(touch);
+				}
+
+				SV_ClipToEntity(clip, touch, headnode);
+			}
+		}
+
+		for (j = 0; j < n; j++)
+		{
+			results[i + j] = clips[j].trace;
+		}
+	}
+}